@@ -44,9 +44,12 @@
 #include <initng/module.h>
 #include <initng/process_db.h>
 #include <initng/signal.h>
+#include <initng/slab.h>
 #include <initng/string.h>
+#include <initng/symbol.h>
 #include <initng/data.h>
 #include <initng/system_states.h>
+#include <initng/timer.h>
 #include <initng/toolbox.h>
 #include <initng/event/all.h>
 #include <initng/config/all.h>
@@ -34,6 +34,7 @@ typedef struct active_type active_db_h;
 #include <initng/active_state.h>
 #include <initng/process_db.h>
 #include <initng/hash.h>
+#include <initng/timer.h>
 
 #define MAX_SUCCEEDED 30
 
@@ -98,19 +99,43 @@ struct active_type {
 
 	/* VARIABLES */
 
-	/* Alarm, the current state alarm is run when this time passes */
-	time_t alarm;
+	/* Alarm, the current state alarm is run when this timer goes off */
+	s_timer alarm;
 
 	/* TEMPORARY STUFF */
 
-	/* depend cache - Optimization to speed up UP_DEPS_CHECK */
-	int depend_cache;
+	/* starts held back by a module go highest rank first, set by modules */
+	int start_rank;
+
+	/* DEPENDENCY GRAPH, see initng/depend.h */
+	struct s_dep_edge *deps;	/* edges to what this depends on */
+	int deps_len;
+	struct s_dep_edge **rdeps;	/* edges pointing at this service */
+	int rdeps_len;
+	int rdeps_size;
+	unsigned int deps_visit;	/* traversal stamp */
+	int deps_id;			/* bit in the reach rows */
+	unsigned long *deps_reach;	/* cached deep deps, as a bitset */
+	unsigned int deps_reach_gen;	/* graph generation of deps_reach */
+	int deps_unmet;			/* start deps not up yet */
+	int deps_cycle;			/* in a circular dep, can't start */
+	int stop_wave;			/* shutdown wave, 0 if not planned */
+	int start_wanted;		/* asked to start while new */
+
+	/* name_hash of the service this one is parked waiting for */
+	hash_t wait_for;
+
+	/* LAUNCH PLANS, see initng/fork.h */
+	struct s_spawn_plan *spawn_plans;	/* compiled, per process type */
+	unsigned int data_gen;		/* bumped when data changes */
 
 	/* LIST_HEADS */
 
 	/* the list */
 	list_t list;
 	list_t interrupt;
+	list_t wait;
+	list_t deps_dirty;
 };
 
 /* allocate */
@@ -124,11 +149,13 @@ active_db_h *initng_active_db_find_by_pid(pid_t pid);
 void initng_active_db_compensate_time(time_t skew);
 
 /* the db */
-#define initng_active_db_unregister(serv) initng_list_del(&(serv)->list)
 int initng_active_db_register(active_db_h * new_a);
+void initng_active_db_unregister(active_db_h * serv);
 int initng_active_db_count(a_state_h * state);
+void initng_active_db_count_state(active_db_h * service, int delta);
 void initng_active_db_free(active_db_h * pf);
 void initng_active_db_free_all(void);
+void initng_active_db_data_changed(data_head * d, s_entry * type);
 
 /* utils */
 int initng_active_db_percent_started(void);
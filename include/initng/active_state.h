@@ -52,6 +52,9 @@ struct a_state_t {
 	 */
 	void (*alarm) (active_db_h *service);
 
+	/* The number of registered services on this state */
+	int count;
+
 	/* The list this struct is in */
 	list_t list;
 };
@@ -59,8 +62,7 @@ struct a_state_t {
 /* register */
 int initng_active_state_register(a_state_h *state);
 
-#define initng_active_state_unregister(st) \
-	initng_list_del(&(st)->list)
+void initng_active_state_unregister(a_state_h *state);
 
 /* searching */
 a_state_h *initng_active_state_find(const char *state_name);
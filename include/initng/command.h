@@ -108,8 +108,7 @@ typedef struct {
 /* register */
 int initng_command_register(s_command * cmd);
 
-#define initng_command_unregister(cmd) \
-	initng_list_del(&(cmd)->list)
+void initng_command_unregister(s_command * cmd);
 
 void initng_command_unregister_all(void);
 
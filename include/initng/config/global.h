@@ -29,8 +29,6 @@
 #include <initng/static/all.h>
 #include <initng/event/all.h>
 
-#define SIGNAL_STACK 10
-
 /* what to do when last process stops */
 typedef enum
 {
@@ -49,6 +47,7 @@ typedef struct
 {
 	/* all the databases */
 	active_db_h active_db;
+	int active_db_is[IS_WAITING + 1];	/* services per rough state */
 	a_state_h states;
 	ptype_h ptypes;
 	m_h module_db;
@@ -80,16 +79,10 @@ typedef struct
 	char *dev_console;
 	int when_out;
 
-	/* next alarm */
-	time_t next_alarm;
-
 	/* use with THEN_NEW_INIT */
 	char **new_init;
 	int no_circular;
 
-	/* Signal stack, initialized by initng_signal_enable */
-	int signals_got[SIGNAL_STACK];
-
 #ifdef DEBUG
 	/* g.verbose_this
 	   0 = no verbose
@@ -24,6 +24,7 @@
 #include <initng/list.h>
 
 typedef struct ss_data s_data;
+typedef struct s_data_head data_head;
 
 
 /*
@@ -49,14 +50,17 @@ struct ss_data {
 	/* if it is a dynamic variable name, put name here */
 	char *vn;
 
+	/* the data_head this entry is added to, see initng_data_add() */
+	data_head *owner;
+
 	list_t list;
+	list_t type_list;	/* entries of the same type, when indexed */
 };
 
-typedef struct s_data_head data_head;
-
 struct s_data_head {
 	s_data head;				/* This is the header */
 	data_head *res;				/* When no data is found, go look in this s_data */
+	struct s_data_index *index;		/* Per type chains, built on first lookup */
 
 	/*
 	 * function pointers, if set this will be called first before
@@ -64,22 +68,36 @@ struct s_data_head {
 	 */
 	int (*data_request) (data_head * data_head);
 	int (*res_request) (data_head * data_head);
+
+	/* if set, called when an entry of type is added, changed or removed */
+	void (*changed) (data_head * data_head, s_entry * type);
 };
 
 #define DATA_HEAD_INIT(point) { \
 	initng_list_init(&(point)->head.list); \
 	(point)->res=NULL; \
+	(point)->index = NULL; \
 	(point)->data_request = NULL; \
 	(point)->res_request = NULL; \
+	(point)->changed = NULL; \
 }
 
 #define DATA_HEAD_INIT_REQUEST(point, request_data, request_res) { \
 	initng_list_init(&(point)->head.list); \
 	(point)->res=NULL; \
+	(point)->index = NULL; \
 	(point)->data_request = request_data; \
 	(point)->res_request = request_res; \
+	(point)->changed = NULL; \
 }
 
+/*
+ * initng_data_add()
+ * Add an allocated s_data entry to a data_head, never add to the list
+ * directly.
+ */
+void initng_data_add(data_head * d, s_data * data);
+
 /* data walkers */
 s_data *initng_data_get_next_var(s_entry * type, const char *vn, data_head * head,
 				 s_data * last);
@@ -18,9 +18,64 @@
  */
 
 
-#ifndef INTING_DEPEND_H
+#ifndef INITNG_DEPEND_H
 #define INITNG_DEPEND_H
 
+#include <initng/active_db.h>
+#include <initng/data.h>
+#include <initng/hash.h>
+#include <initng/list.h>
+
+/*
+ * The dependency graph. Every registered service has an edge for each
+ * REQUIRE, NEED, USE and provide entry it has, in data order, pointing at
+ * the registered service with that name. Edges to names not registered
+ * yet are resolved when such a service is registered. Every service also
+ * keeps the edges pointing at it, its reverse edges.
+ */
+typedef enum {
+	DEP_REQUIRE = 1,
+	DEP_NEED = 2,
+	DEP_USE = 3,
+	DEP_PROVIDE = 4,
+} e_dep;
+
+typedef struct s_dep_edge s_dep;
+struct s_dep_edge {
+	e_dep type;
+	char *name;
+	hash_t hash;
+	active_db_h *from;
+	active_db_h *to;	/* NULL while unresolved */
+	list_t pending;		/* on the unresolved list while to is NULL */
+	int waiting;		/* counted in from->deps_unmet */
+	int broken;		/* ignored, to break a circular dep */
+};
+
+/* maintained on register, unregister and changes to the deps data */
+void initng_depend_graph_add(active_db_h * service);
+void initng_depend_graph_del(active_db_h * service);
+void initng_depend_graph_changed(data_head * d, s_entry * type);
+
+/* rebuild the edges of services whose deps data changed */
+void initng_depend_graph_sync(void);
+
+/* the start scheduler, run on every state change */
+void initng_depend_unschedule(active_db_h * service);
+void initng_depend_state_changed(active_db_h * dep);
+
+/* walk edges, call initng_depend_graph_sync() first */
+#define while_depend_edges(edge, service) \
+	for ((edge) = (service)->deps; \
+	     (edge) < (service)->deps + (service)->deps_len; (edge)++)
+
+#define while_depend_redges(i, edge, service) \
+	for ((i) = 0; (i) < (service)->rdeps_len && \
+	     ((edge) = (service)->rdeps[(i)]); (i)++)
+
+/* the edges that make service depend on to, not provide */
+#define DEP_IS_DEPEND(edge) ((edge)->type != DEP_PROVIDE && !(edge)->broken)
+
 /* dependecy checkings */
 int initng_depend(active_db_h * service, active_db_h * check);
 int initng_depend_deep(active_db_h * service, active_db_h * check);
@@ -30,6 +85,9 @@ int initng_depend_any_depends_on(active_db_h * service);
 int initng_depend_stop_deps(active_db_h * service);
 int initng_depend_stop_dep_met(active_db_h * service, int verbose);
 
+/* Split the services to stop in waves, returns the number of waves */
+int initng_depend_stop_waves(void);
+
 /* To start deps, and if its ok to start a service */
 int initng_depend_start_deps(active_db_h * service);
 int initng_depend_start_dep_met(active_db_h * service, int verbose);
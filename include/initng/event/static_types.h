@@ -21,8 +21,6 @@
 #ifndef INITNG_STATIC_EVENT_TYPES_H
 #define INITNG_STATIC_EVENT_TYPES_H
 
-#include <sys/select.h>
-
 extern s_event_type EVENT_STATE_CHANGE;
 extern s_event_type EVENT_SYSTEM_CHANGE;
 extern s_event_type EVENT_IS_CHANGE;
@@ -30,6 +28,7 @@ extern s_event_type EVENT_UP_MET;
 extern s_event_type EVENT_MAIN;
 extern s_event_type EVENT_LAUNCH;
 extern s_event_type EVENT_AFTER_FORK;
+extern s_event_type EVENT_SPAWN_PLAN;
 extern s_event_type EVENT_START_DEP_MET;
 extern s_event_type EVENT_STOP_DEP_MET;
 extern s_event_type EVENT_PIPE_WATCHER;
@@ -44,6 +43,7 @@ extern s_event_type EVENT_SIGNAL;
 extern s_event_type EVENT_BUFFER_WATCHER;
 extern s_event_type EVENT_IO_WATCHER;
 extern s_event_type EVENT_INTERRUPT;
+extern s_event_type EVENT_STOP_WAVE;
 extern s_event_type HALT;
 extern s_event_type REBOOT;
 
@@ -63,6 +63,12 @@ typedef struct {
 	process_h *process;
 } s_event_after_fork_data, s_event_handle_killed_data;
 
+typedef struct {
+	active_db_h *service;
+	process_h *process;
+	s_spawn *plan;
+} s_event_spawn_plan_data;
+
 typedef struct {
 	active_db_h *service;
 	process_h *process;
@@ -88,16 +94,22 @@ typedef struct {
 	char *buffer_pos;
 } s_event_buffer_watcher_data;
 
+typedef struct {
+	int wave, waves;	/* the wave, counted from 1, of all */
+	int services;		/* services stopped in it */
+	int left;		/* not down yet, 0 when it is done */
+} s_event_stop_wave_data;
+
 /* EVENT_IO_WATCHER actions */
+/*
+ * File descriptors are polled through initng_io_fd_register(), this event
+ * is only used to close all of them, or to list them.
+ */
 #define IOW_ACTION_CLOSE	1
-#define IOW_ACTION_CHECK	2
-#define IOW_ACTION_CALL		3
 #define IOW_ACTION_DEBUG	4
 
 typedef struct {
 	int action;
-	int added;
-	fd_set *readset, *writeset, *errset;
 	char *debug_find_what;
 	char **debug_out;
 } s_event_io_watcher_data;
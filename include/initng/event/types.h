@@ -29,6 +29,7 @@ typedef struct s_event_type_s {
 	const char *description;
 
 	s_call hooks;
+	unsigned int hooks_gen;		/* bumped when a hook comes or goes */
 
 	int name_len;
 	list_t list;
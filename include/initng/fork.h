@@ -20,11 +20,77 @@
 #ifndef INITNG_FORK_H
 #define INITNG_FORK_H
 #include <unistd.h>					/* pid_t */
+#include <sys/types.h>					/* uid_t gid_t */
+#include <sys/resource.h>				/* struct rlimit */
 
 #include <initng/active_db.h>					/* active_h */
 #include <initng/process_db.h>					/* process_h */
 
+#define SPAWN_FDS 8
+#define SPAWN_LIMITS 16
+#define SPAWN_GROUPS 64
+#define SPAWN_ENV 8
+
+/*
+ * What a spawned child does before execve, filled in by modules hooking
+ * EVENT_SPAWN_PLAN. It is worked out in initng, and compiled to a list
+ * of syscalls kept with the service until its data changes, so the
+ * child only makes them, in this order: fds, limits, nice, chroot,
+ * chdir, groups, gid and uid. The env is added to the one of the
+ * service.
+ */
+typedef struct {
+	/* fork the child, and send EVENT_AFTER_FORK in it */
+	int fork;
+
+	/* don't keep it, it depends on more than the service data */
+	int nocache;
+
+	/* open path onto to if set, else dup2(from, to), as added */
+	struct {
+		const char *path;
+		int flags;
+		int from;
+		int to;
+	} fds[SPAWN_FDS];
+	int fds_len;
+
+	struct {
+		int resource;
+		struct rlimit rlim;
+	} limits[SPAWN_LIMITS];
+	int limits_len;
+
+	int set_nice;
+	int nice;
+
+	const char *chroot;		/* chdir to, and chroot */
+	const char *chdir;
+
+	int groups_len;			/* -1 to leave them */
+	gid_t groups[SPAWN_GROUPS];
+	gid_t gid;			/* 0 to leave it */
+	uid_t uid;			/* 0 to leave it */
+
+	/* over the defaults, but not what the service sets in env */
+	struct {
+		const char *name;
+		const char *value;
+	} env[SPAWN_ENV];
+	int env_len;
+} s_spawn;
+
 pid_t initng_fork(active_db_h * service, process_h * process);
 void initng_fork_aforkhooks(active_db_h * service, process_h * process);
 
+pid_t initng_spawn(active_db_h * service, process_h * process, char **argv);
+int initng_spawn_add_open(s_spawn * plan, const char *path, int flags,
+			  int to);
+int initng_spawn_add_fd(s_spawn * plan, int from, int to);
+int initng_spawn_add_limit(s_spawn * plan, int resource,
+			   const struct rlimit *rlim);
+int initng_spawn_add_env(s_spawn * plan, const char *name,
+			 const char *value);
+void initng_spawn_plans_free(active_db_h * service);
+
 #endif /* INITNG_FORK_H */
@@ -30,10 +30,12 @@ int initng_handler_start_service(active_db_h * service);
 int initng_handler_stop_service(active_db_h * service);
 int initng_handler_restart_service(active_db_h * service);
 active_db_h *initng_handler_start_new_service_named(const char *service);
-void initng_handler_run_alarm(void);
+void initng_handler_run_alarm(s_timer * alarm);
 int initng_handler_stop_all(void);
+void initng_handler_stop_wave_changed(active_db_h * service);
 
-/* when set an alarm, we update service->alarm, and set g.next_alarm if this is the closest one */
-#define initng_handler_set_alarm(service, seconds) { service->alarm = g.now.tv_sec + seconds; if(g.next_alarm==0 || service->alarm < g.next_alarm) g.next_alarm = service->alarm; }
+/* arm service->alarm, the alarm of the current state is called when it goes off */
+#define initng_handler_set_alarm_ms(service, ms) initng_timer_arm(&(service)->alarm, ms)
+#define initng_handler_set_alarm(service, seconds) initng_handler_set_alarm_ms(service, (seconds) * 1000)
 
 #endif /* INITNG_HANDLER_H */
@@ -22,4 +22,10 @@
 
 int initng_interrupt(void);
 
+void initng_interrupt_wait_for(active_db_h * service, const char *name);
+void initng_interrupt_wait_all(active_db_h * service);
+void initng_interrupt_hold(active_db_h * service);
+void initng_interrupt_unwait(active_db_h * service);
+void initng_interrupt_ready(active_db_h * service);
+
 #endif /* INITNG_INTERRUPT_H */
@@ -26,6 +26,7 @@
 #include <fcntl.h>
 
 #include <initng/active_db.h>
+#include <initng/fdw.h>
 
 char *initng_io_readwhole(const char *path);
 
@@ -41,6 +42,16 @@ inline static int initng_io_set_cloexec(int fd)
 
 void initng_io_process_read_input(active_db_h * service, process_h * p,
 				  pipe_h * pipe);
-void initng_io_module_poll(int timeout);
+void initng_io_module_poll(int timeout_ms);
+
+/* file descriptor watches, polled by initng_io_module_poll() */
+int initng_io_fd_register(f_module_h * fdw);
+int initng_io_fd_update(f_module_h * fdw);
+void initng_io_fd_unregister(f_module_h * fdw);
+
+/* watch all pipes of a process, done by initng_fork() */
+void initng_io_process_register(active_db_h * service, process_h * process);
+void initng_io_process_unregister(process_h * process);
+void initng_io_pipe_unregister(pipe_h * pipe);
 
 #endif /* !defined(INITNG_IO_H) */
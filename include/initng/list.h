@@ -75,9 +75,9 @@ static inline void initng_list_add_tail(list_t *newe, list_t *head)
 		return;
 
 	head->prev->next = newe;
-	head->prev = newe;
-	newe->next = head;
 	newe->prev = head->prev;
+	newe->next = head;
+	head->prev = newe;
 }
 
 /**
@@ -26,20 +26,7 @@
 #include <initng/active_db.h>
 #include <initng/msg.h>
 #include <initng/event/event.h>
-
-/* flags for f_module_h.what - correspond to the arguments of select() */
-typedef enum {
-	IOW_READ = 1,	/* Want notification when data is ready to be read */
-	IOW_WRITE = 2,	/* when data can be written successfully */
-	IOW_ERROR = 4,	/* when an exceptional condition occurs */
-} e_fdw;
-
-typedef struct ft_module_h f_module_h;
-struct ft_module_h {
-	void (*call_module) (f_module_h * module, e_fdw what);
-	e_fdw what;
-	int fds;
-};
+#include <initng/fdw.h>
 
 typedef union {
 	/* a skeleton, newer use */
@@ -24,7 +24,7 @@
 
 /* Add to this counter everytime the api changes, and modules need to
  * recompile */
-#define API_VERSION 19
+#define API_VERSION 20
 
 /* define this struct on every module */
 struct initng_module {
@@ -25,6 +25,7 @@
 
 #include <initng/active_db.h>
 #include <initng/list.h>
+#include <initng/fdw.h>
 
 /* this doesn't work!, it will create a circular dependency */
 /* so we use a struct prototype !! */
@@ -70,6 +71,12 @@ typedef struct {
 	int buffer_len;		/* the count of chars from the beginning in
 				 * buffer right now */
 
+	/* The watch registered in the main loop, call_module is only set
+	 * while the pipe is registered, see initng_io_process_register() */
+	f_module_h fdw;
+	active_db_h *service;
+	process_h *process;
+
 	/* The list entry */
 	list_t list;
 } pipe_h;
@@ -116,6 +123,12 @@ process_h *initng_process_db_get_by_name(const char *name,
 					 active_db_h *service);
 process_h *initng_process_db_get_by_pid(pid_t pid, active_db_h * service);
 
+/* the pid index */
+void initng_process_db_set_pid(process_h * process, active_db_h * service,
+			       pid_t pid);
+void initng_process_db_unindex_pid(process_h * process);
+process_h *initng_process_db_find_by_pid(pid_t pid, active_db_h ** service);
+
 #define while_processes(current, service) \
 	initng_list_foreach_rev(current, &service->processes.list, list)
 
@@ -129,11 +142,12 @@ process_h *initng_process_db_get_by_pid(pid_t pid, active_db_h * service);
 #define while_ptypes_safe(current, safe) \
 	initng_list_foreach_rev_safe(current, safe, &g.ptypes.list, list)
 
-#define initng_process_db_ptype_register(pt) \
-	initng_list_add(&(pt)->list, &g.ptypes.list)
+#define initng_process_db_ptype_register(pt) { \
+	initng_list_add(&(pt)->list, &g.ptypes.list); \
+	initng_symbol_add(SYMBOL_PTYPE, (pt)->name, (pt)); \
+}
 
-#define initng_process_db_ptype_unregister(pt) \
-	initng_list_del(&(pt)->list)
+void initng_process_db_ptype_unregister(ptype_h * pt);
 
 #define initng_process_db_register_to_service(p_t_a, s_t_a) \
 	initng_list_add(&(p_t_a)->list, &(s_t_a)->processes.list)
@@ -58,10 +58,11 @@ typedef struct {
 		(st)->name_len=0;			\
 	} 						\
 	initng_list_add(&(st)->list, &g.stypes.list);	\
+	if ((st)->name)					\
+		initng_symbol_add(SYMBOL_STYPE, (st)->name, (st)); \
 }
 
-#define initng_service_type_unregister(st) \
-	initng_list_del(&(st)->list)
+void initng_service_type_unregister(stype_h *st);
 
 /* service_db walker */
 #define while_service_types(current) \
@@ -0,0 +1,71 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef INITNG_SLAB_H
+#define INITNG_SLAB_H
+
+#include <stddef.h>
+#include <initng/list.h>
+
+/*
+ * A cache of fixed size records, carved out of larger slabs and kept on a
+ * free list when released. Each cache keeps a reserve of free records, so
+ * running out of memory does not stall the main loop right away.
+ */
+typedef struct {
+	const char *name;
+	size_t size;		/* record size */
+	int per_slab;		/* records carved out of every slab */
+	int reserve;		/* free records to keep at hand */
+
+	void *free_list;
+	int free_count;
+
+	/* statistics */
+	int slabs;
+	int in_use;
+	int peak;
+	unsigned long allocs;
+	unsigned long frees;
+	unsigned long grow_failed;
+
+	list_t list;
+} s_slab_cache;
+
+#define SLAB_CACHE(cname, type, per, res) { \
+	.name = cname, \
+	.size = sizeof(type), \
+	.per_slab = per, \
+	.reserve = res, \
+}
+
+/* the caches of initng core records */
+extern s_slab_cache initng_slab_active_db;
+extern s_slab_cache initng_slab_process;
+extern s_slab_cache initng_slab_pipe;
+extern s_slab_cache initng_slab_data;
+
+/* returns a zeroed record */
+void *initng_slab_alloc(s_slab_cache * cache);
+void initng_slab_free(s_slab_cache * cache, void *ptr);
+
+/* a printable summary of all caches, free it when done */
+char *initng_slab_stats(void);
+
+#endif /* INITNG_SLAB_H */
@@ -0,0 +1,46 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef INITNG_SYMBOL_H
+#define INITNG_SYMBOL_H
+
+/*
+ * The named registries (options, states, events, commands, service types
+ * and process types) keep their lists, and intern their names in one
+ * shared hash table for lookups. Names are not copied, they must live as
+ * long as the registered entry.
+ */
+typedef enum {
+	SYMBOL_OPTION = 1,
+	SYMBOL_STATE = 2,
+	SYMBOL_EVENT = 3,
+	SYMBOL_COMMAND = 4,
+	SYMBOL_STYPE = 5,
+	SYMBOL_PTYPE = 6,
+} e_symbol;
+
+/* returns FALSE if the name is already taken in that registry */
+int initng_symbol_add(e_symbol kind, const char *name, void *ptr);
+
+/* returns TRUE if ptr was the one interned on name */
+int initng_symbol_del(e_symbol kind, const char *name, void *ptr);
+
+void *initng_symbol_find(e_symbol kind, const char *name);
+
+#endif /* INITNG_SYMBOL_H */
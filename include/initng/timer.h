@@ -0,0 +1,58 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef INITNG_TIMER_H
+#define INITNG_TIMER_H
+
+#include <stdint.h>
+
+/*
+ * A timer, embed this in the struct it belongs to, and use
+ * initng_list_entry() in the callback to get it back.
+ * All times are milliseconds of the monotonic clock, so timers are not
+ * affected by changes of the wall clock.
+ */
+typedef struct s_timer_s s_timer;
+struct s_timer_s {
+	/* called from the main loop, when due has passed */
+	void (*call) (s_timer * timer);
+
+	/* when to call */
+	uint64_t due;
+
+	/* position in the timer heap, -1 if not armed */
+	int index;
+};
+
+#define initng_timer_init(timer, func) \
+	{ (timer)->call = (func); (timer)->due = 0; (timer)->index = -1; }
+
+#define initng_timer_is_armed(timer) ((timer)->index >= 0)
+
+uint64_t initng_timer_now(void);
+
+/* arm, or re-arm, a timer to go off in ms milliseconds */
+void initng_timer_arm(s_timer * timer, int ms);
+void initng_timer_cancel(s_timer * timer);
+
+/* milliseconds to the next timer, 0 if one is due, or -1 if none */
+int initng_timer_next(void);
+void initng_timer_run(void);
+
+#endif /* INITNG_TIMER_H */
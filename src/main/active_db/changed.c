@@ -0,0 +1,37 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+
+#include <string.h>
+
+/*
+ * The data change hook of every active_db entry, the deps edges and
+ * launch plans built from its data have to be made again. The internal
+ * entries are what initng keeps track of at runtime, like the last
+ * respawn of a daemon, no launch plan is made from them.
+ */
+void initng_active_db_data_changed(data_head * d, s_entry * type)
+{
+	active_db_h *service = initng_list_entry(d, active_db_h, data);
+
+	if (!type || !type->name || strncmp(type->name, "internal", 8) != 0)
+		service->data_gen++;
+	initng_depend_graph_changed(d, type);
+}
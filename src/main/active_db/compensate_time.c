@@ -46,6 +46,5 @@ void initng_active_db_compensate_time(time_t skew)
 		current->time_current_state.tv_sec += skew;
 		current->time_last_state.tv_sec += skew;
 		current->last_rought_time.tv_sec += skew;
-		current->alarm += skew;
 	}
 }
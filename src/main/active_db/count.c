@@ -28,6 +28,24 @@
 
 #include <initng.h>
 
+/**
+ * Account for a service on its current state.
+ *
+ * @param service
+ * @param delta   1 when it enters the state, -1 when it leaves.
+ *
+ * Keeps the per state and per rough state counters up to date, called
+ * when a registered service changes state, and on register/unregister.
+ */
+void initng_active_db_count_state(active_db_h * service, int delta)
+{
+	assert(service);
+
+	g.active_db_is[GET_STATE(service)] += delta;
+	if (service->current_state)
+		service->current_state->count += delta;
+}
+
 /**
  * Count services on a given state.
  *
@@ -40,34 +58,17 @@
 int initng_active_db_count(a_state_h * state_to_count)
 {
 	int counter = 0;	/* actives counter */
-	active_db_h *current = NULL;
-
-	/* ok, go COUNT ALL */
-	if (!state_to_count) {
-		/* ok, go through all */
-		while_active_db(current) {
-			assert(current->name);
-
-			/* don't count failed and stopped */
-			switch (GET_STATE(current)) {
-			case IS_FAILED:
-			case IS_DOWN:
-				continue;
-			}
+	int i;
 
-			counter++;
-		}
+	/* ok, go COUNT A SPECIAL */
+	if (state_to_count)
+		return state_to_count->count;
 
-		return counter;
+	/* ok, go COUNT ALL, don't count failed and stopped */
+	for (i = 0; i <= IS_WAITING; i++) {
+		if (i != IS_FAILED && i != IS_DOWN)
+			counter += g.active_db_is[i];
 	}
 
-	/* ok, go COUNT A SPECIAL */
-	while_active_db(current) {
-		assert(current->name);
-		/* check if this is the status to count */
-		if (current->current_state == state_to_count)
-			counter++;
-	}
-	/* return counter */
 	return counter;
 }
@@ -27,6 +27,7 @@
 #include <time.h>
 
 #include <initng.h>
+#include "local.h"
 
 /**
  * Search a service trought active_db by exact name.
@@ -38,24 +39,9 @@
  */
 active_db_h * initng_active_db_find_by_name(const char *service)
 {
-	active_db_h *current = NULL;
-
 	assert(service);
 
-	hash_t hash = initng_hash_str(service);
-
-	/* first, search for an exact match */
-	while_active_db(current) {
-		if (current->name_hash == hash) {
-			assert(current->name);
-
-			if (strcmp(current->name, service) == 0)
-				return current;
-		}
-	}
-
-	/* did not found any */
-	return NULL;
+	return initng_active_db_index_find(service);
 }
 
 /**
@@ -69,18 +55,10 @@ active_db_h * initng_active_db_find_by_name(const char *service)
  */
 active_db_h *initng_active_db_find_by_pid(pid_t pid)
 {
-	active_db_h *currentA = NULL;
-	process_h *currentP = NULL;
+	active_db_h *service = NULL;
 
-	/* walk the active_db */
-	while_active_db(currentA) {
-		currentP = NULL;
-		while_processes(currentP, currentA) {
-			if (currentP->pid == pid)
-				return currentA;
-		}
-	}
+	if (!initng_process_db_find_by_pid(pid, &service))
+		return NULL;
 
-	/* bad luck */
-	return NULL;
+	return service;
 }
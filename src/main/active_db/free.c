@@ -49,8 +49,10 @@ void initng_active_db_free(active_db_h * pf)
 	initng_common_mark_service(pf, &FREEING);
 
 	/* unregister from all lists */
-	initng_list_del(&pf->list);
+	initng_active_db_unregister(pf);
 	initng_list_del(&pf->interrupt);
+	initng_interrupt_unwait(pf);
+	initng_timer_cancel(&pf->alarm);
 
 	while_processes_safe(current, safe, pf) {
 		initng_process_db_real_free(current);
@@ -58,12 +60,13 @@ void initng_active_db_free(active_db_h * pf)
 
 	/* remove every data entry */
 	remove_all(pf);
+	initng_spawn_plans_free(pf);
 
 	/* free service name */
 	free(pf->name);
 
 	/* free service struct */
-	free(pf);
+	initng_slab_free(&initng_slab_active_db, pf);
 }
 
 /**
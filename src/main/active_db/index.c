@@ -0,0 +1,133 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include <initng.h>
+#include "local.h"
+
+#define INDEX_MIN_SIZE 64
+
+/*
+ * Slots are NULL when never used, and point at deleted when the entry in
+ * them was removed, so a probe for a later entry does not stop there.
+ */
+static active_db_h **slots = NULL;
+static size_t size = 0;		/* always a power of two */
+static size_t used = 0;		/* live entries */
+static size_t filled = 0;	/* live entries and deleted slots */
+static char deleted;
+
+#define DELETED ((active_db_h *) &deleted)
+
+static size_t probe(hash_t hash, size_t i)
+{
+	return (hash + i) & (size - 1);
+}
+
+static void rehash(size_t new_size)
+{
+	active_db_h **old = slots;
+	size_t old_size = size;
+	size_t i, j;
+
+	slots = initng_toolbox_calloc(new_size, sizeof(active_db_h *));
+	size = new_size;
+	filled = used;
+
+	for (i = 0; i < old_size; i++) {
+		if (!old[i] || old[i] == DELETED)
+			continue;
+
+		for (j = 0; slots[probe(old[i]->name_hash, j)]; j++) ;
+		slots[probe(old[i]->name_hash, j)] = old[i];
+	}
+
+	free(old);
+}
+
+void initng_active_db_index_add(active_db_h * service)
+{
+	size_t i, slot;
+
+	assert(service);
+
+	/* keep the table at most half full, counting deleted slots */
+	if ((filled + 1) * 2 > size) {
+		size_t new_size = INDEX_MIN_SIZE;
+
+		while ((used + 1) * 2 > new_size / 2)
+			new_size *= 2;
+		rehash(new_size);
+	}
+
+	for (i = 0;; i++) {
+		slot = probe(service->name_hash, i);
+		if (!slots[slot] || slots[slot] == DELETED)
+			break;
+	}
+
+	if (!slots[slot])
+		filled++;
+	slots[slot] = service;
+	used++;
+}
+
+void initng_active_db_index_del(active_db_h * service)
+{
+	size_t i, slot;
+
+	assert(service);
+
+	if (!size)
+		return;
+
+	for (i = 0; slots[slot = probe(service->name_hash, i)]; i++) {
+		if (slots[slot] == service) {
+			slots[slot] = DELETED;
+			used--;
+			return;
+		}
+	}
+}
+
+active_db_h *initng_active_db_index_find(const char *name)
+{
+	hash_t hash;
+	size_t i, slot;
+
+	assert(name);
+
+	if (!used)
+		return NULL;
+
+	hash = initng_hash_str(name);
+	for (i = 0; slots[slot = probe(hash, i)]; i++) {
+		if (slots[slot] == DELETED ||
+		    slots[slot]->name_hash != hash)
+			continue;
+
+		if (strcmp(slots[slot]->name, name) == 0)
+			return slots[slot];
+	}
+
+	return NULL;
+}
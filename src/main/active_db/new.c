@@ -42,7 +42,7 @@ active_db_h *initng_active_db_new(const char *name)
 
 	/* allocate a new active entry */
 	new_active =
-	    (active_db_h *) initng_toolbox_calloc(1, sizeof(active_db_h));
+	    (active_db_h *) initng_slab_alloc(&initng_slab_active_db);
 	if (!new_active) {
 		F_("Unable to allocate active, out of memory?\n");
 		return NULL;
@@ -60,6 +60,9 @@ active_db_h *initng_active_db_new(const char *name)
 
 	DATA_HEAD_INIT_REQUEST(&new_active->data, NULL, NULL);
 
+	/* keep the edges and launch plans in sync with the data */
+	new_active->data.changed = &initng_active_db_data_changed;
+
 	/* get the time, and copy that time to all time entries */
 	gettimeofday(&new_active->time_current_state, NULL);
 	memcpy(&new_active->time_last_state, &new_active->time_current_state,
@@ -72,7 +75,7 @@ active_db_h *initng_active_db_new(const char *name)
 	new_active->current_state = &NEW;
 
 	/* reset alarm */
-	new_active->alarm = 0;
+	initng_timer_init(&new_active->alarm, &initng_handler_run_alarm);
 
 	new_active->name_hash = initng_hash_str(name);
 
@@ -33,31 +33,15 @@
  *
  * @return percentage
  *
- * Walks throught the active_db looking for started processes and calculates
- * the percentage of started ones.
+ * Uses the rough state counters of the active_db to calculate the
+ * percentage of started ones.
  */
 int initng_active_db_percent_started(void)
 {
-	active_db_h *current = NULL;
-	int starting = 0, up = 0, other = 0;
+	int starting = g.active_db_is[IS_STARTING];
+	int up = g.active_db_is[IS_UP];
 
-	while_active_db(current) {
-		assert(current->name);
-		assert(current->current_state);
-
-		switch (GET_STATE(current)) {
-		case IS_STARTING:
-			starting++;
-			break;
-		case IS_UP:
-			up++;
-			break;
-		default:
-			other++;
-			break;
-		}
-	}
-	D_("up: %i  starting: %i  other: %i\n", up, starting, other);
+	D_("up: %i  starting: %i\n", up, starting);
 
 	int ret = 0;
 	/* if no one is starting */
@@ -75,32 +59,15 @@ int initng_active_db_percent_started(void)
  *
  * @return percentage
  *
- * Walks throught the active_db looking for stopped processes and calculates
- * the percentage of started ones.
+ * Uses the rough state counters of the active_db to calculate the
+ * percentage of stopped ones.
  */
 int initng_active_db_percent_stopped(void)
 {
-	active_db_h *current = NULL;
-	int stopping = 0, down = 0, other = 0;
-
-	while_active_db(current) {
-		assert(current->name);
-		assert(current->current_state);
-
-		switch (GET_STATE(current)) {
-		case IS_DOWN:
-			down++;
-			break;
-		case IS_STOPPING:
-			stopping++;
-			break;
-		default:
-			other++;
-			break;
-		}
-	}
+	int stopping = g.active_db_is[IS_STOPPING];
+	int down = g.active_db_is[IS_DOWN];
 
-	D_("down: %i  stopping: %i  other: %i\n", down, stopping, other);
+	D_("down: %i  stopping: %i\n", down, stopping);
 
 	int ret = 0;
 	/* if no one stopping */
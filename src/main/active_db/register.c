@@ -27,6 +27,7 @@
 #include <time.h>
 
 #include <initng.h>
+#include "local.h"
 
 /**
  * Add a service to the active_db.
@@ -54,6 +55,28 @@ int initng_active_db_register(active_db_h * add_this)
 	}
 
 	initng_list_add(&add_this->list, &g.active_db.list);
+	initng_active_db_index_add(add_this);
+	initng_active_db_count_state(add_this, 1);
+	initng_depend_graph_add(add_this);
 
 	return TRUE;
 }
+
+/**
+ * Remove a service from the active_db, without freeing it.
+ *
+ * @param service
+ */
+void initng_active_db_unregister(active_db_h * service)
+{
+	assert(service);
+
+	/* only if it was registered */
+	if (!service->list.next)
+		return;
+
+	initng_depend_graph_del(service);
+	initng_list_del(&service->list);
+	initng_active_db_index_del(service);
+	initng_active_db_count_state(service, -1);
+}
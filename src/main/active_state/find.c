@@ -31,14 +31,7 @@
  */
 a_state_h *initng_active_state_find(const char *state_name)
 {
-	a_state_h *current = NULL;
-
 	assert(state_name);
 
-	/* walk the state db */
-	while_active_states(current) {
-		if (strcmp(state_name, current->name) == 0)
-			return current;
-	}
-	return NULL;
+	return initng_symbol_find(SYMBOL_STATE, state_name);
 }
@@ -43,7 +43,21 @@ int initng_active_state_register(a_state_h * state)
 	D_("adding %s.\n", state->name);
 	/* add this state, to the big list of states */
 	initng_list_add(&(state->list), &(g.states.list));
+	initng_symbol_add(SYMBOL_STATE, state->name, state);
 
 	/* return happily */
 	return TRUE;
 }
+
+/**
+ * Unregister a state.
+ *
+ * @param state
+ */
+void initng_active_state_unregister(a_state_h * state)
+{
+	assert(state);
+
+	initng_list_del(&state->list);
+	initng_symbol_del(SYMBOL_STATE, state->name, state);
+}
@@ -38,11 +38,7 @@ s_command *initng_command_find_by_command_id(char cid)
 /* look for a command by command_id */
 s_command *initng_command_find_by_command_string(char *name)
 {
-	s_command *current = NULL;
+	assert(name);
 
-	while_command_db(current) {
-		if (current->long_id && strcmp(current->long_id, name) == 0)
-			return current;
-	}
-	return NULL;
+	return initng_symbol_find(SYMBOL_COMMAND, name);
 }
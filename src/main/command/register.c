@@ -41,9 +41,33 @@ int initng_command_register(s_command * cmd)
 
 	/* add this command to list */
 	initng_list_add(&cmd->list, &g.command_db.list);
+	if (cmd->long_id)
+		initng_symbol_add(SYMBOL_COMMAND, cmd->long_id, cmd);
 	return TRUE;
 }
 
+void initng_command_unregister(s_command * cmd)
+{
+	assert(cmd);
+
+	initng_list_del(&cmd->list);
+
+	/* if another command had the same name, it is found from now on */
+	if (cmd->long_id &&
+	    initng_symbol_del(SYMBOL_COMMAND, cmd->long_id, cmd)) {
+		s_command *current = NULL;
+
+		while_command_db(current) {
+			if (current->long_id &&
+			    strcmp(current->long_id, cmd->long_id) == 0) {
+				initng_symbol_add(SYMBOL_COMMAND,
+						  current->long_id, current);
+				break;
+			}
+		}
+	}
+}
+
 void initng_command_unregister_all(void)
 {
 	s_command *current, *safe = NULL;
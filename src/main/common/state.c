@@ -121,8 +121,15 @@ int initng_common_state_unlock(active_db_h * service)
 	}
 
 	/* reset alarm, set state and time */
-	service->alarm = 0;
-	service->current_state = service->next_state;
+	initng_timer_cancel(&service->alarm);
+
+	/* move it between the state counters, if registered */
+	if (service->list.next) {
+		initng_active_db_count_state(service, -1);
+		service->current_state = service->next_state;
+		initng_active_db_count_state(service, 1);
+	} else
+		service->current_state = service->next_state;
 	gettimeofday(&service->time_current_state, NULL);
 
 	/* Set INTERRUPT, the interrupt is set only when a service
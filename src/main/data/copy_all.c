@@ -40,10 +40,11 @@ void initng_data_copy_all(data_head * from, data_head * to)
 			continue;
 
 		/* allocate the new one */
-		tmp = (s_data *) initng_toolbox_calloc(1, sizeof(s_data));
+		tmp = (s_data *) initng_slab_alloc(&initng_slab_data);
 
 		/* copy */
 		memcpy(tmp, current, sizeof(s_data));
+		tmp->list.next = tmp->list.prev = NULL;
 
 		/* copy the data */
 		switch (current->type->type) {
@@ -65,6 +66,6 @@ void initng_data_copy_all(data_head * from, data_head * to)
 			tmp->vn = NULL;
 
 		/* add to list */
-		initng_list_add(&tmp->list, &to->head.list);
+		initng_data_add(to, tmp);
 	}
 }
@@ -65,8 +65,31 @@ s_data *initng_data_get_next_var(s_entry * type, const char *vn,
 	if (head->data_request && (*head->data_request) (head) == FALSE)
 		return NULL;
 
-	/* Make sure the list is not empty */
-	if (!initng_list_isempty(&head->head.list)) {
+	/*
+	 * With a type, walk only the chain of that type. If last is not
+	 * ours, it is in head->res, and nothing here comes after it.
+	 */
+	if (type && (!last || (last->owner == head && last->type == type))) {
+		list_t *chain = initng_data_index_chain(head, type);
+
+		if (chain)
+			place = last ? last->type_list.prev : chain->prev;
+		last = NULL;
+
+		while (place && place != chain) {
+			current = initng_list_entry(place, s_data, type_list);
+
+			if (!current->vn || !vn || strcmp(current->vn, vn) == 0)
+				return current;
+
+			place = place->prev;
+		}
+
+		place = NULL;
+	} else if (type && last->owner != head) {
+		/* skip to head->res */
+	} else if (!initng_list_isempty(&head->head.list)) {
+		/* Make sure the list is not empty */
 		/* put place on the initial */
 		place = head->head.list.prev;
 	}
@@ -0,0 +1,139 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "local.h"
+
+#define INDEX_MIN_SIZE 16
+
+static unsigned int probe(s_entry * type, unsigned int i, unsigned int size)
+{
+	return ((uint32_t) ((uintptr_t) type >> 3) * 2654435761U + i) &
+	    (size - 1);
+}
+
+/* find the chain of type, or claim a free slot for it */
+static list_t *lookup(struct s_data_index *index, s_entry * type, int create)
+{
+	unsigned int i, slot;
+
+	for (i = 0; index->slot[slot = probe(type, i, index->size)].type;
+	     i++) {
+		if (index->slot[slot].type == type)
+			return &index->slot[slot].chain;
+	}
+
+	if (!create)
+		return NULL;
+
+	index->slot[slot].type = type;
+	initng_list_init(&index->slot[slot].chain);
+	index->used++;
+	return &index->slot[slot].chain;
+}
+
+/*
+ * (Re)build the index of d, linking every entry in list order.
+ */
+static void build(data_head * d, unsigned int size)
+{
+	struct s_data_index *index;
+	s_data *current = NULL;
+
+	for (;;) {
+		index = initng_toolbox_calloc(1, sizeof(struct s_data_index) +
+					      size * sizeof(index->slot[0]));
+		index->size = size;
+
+		/* oldest first, so every chain keeps the order of the list */
+		initng_list_foreach_rev(current, &d->head.list, list) {
+			if (!current->type)
+				continue;
+
+			current->type_list.next = current->type_list.prev = NULL;
+			initng_list_add(&current->type_list,
+					lookup(index, current->type, TRUE));
+
+			/* keep it at most half full */
+			if (index->used * 2 > index->size)
+				break;
+		}
+
+		if (&current->list == &d->head.list)
+			break;
+
+		free(index);
+		size *= 2;
+	}
+
+	free(d->index);
+	d->index = index;
+}
+
+/*
+ * Returns the chain of entries of type in d, NULL if there are none.
+ */
+list_t *initng_data_index_chain(data_head * d, s_entry * type)
+{
+	assert(d);
+	assert(type);
+
+	if (!d->index)
+		build(d, INDEX_MIN_SIZE);
+
+	return lookup(d->index, type, FALSE);
+}
+
+void initng_data_index_free(data_head * d)
+{
+	assert(d);
+
+	free(d->index);
+	d->index = NULL;
+}
+
+void initng_data_add(data_head * d, s_data * data)
+{
+	assert(d);
+	assert(data);
+
+	data->owner = d;
+	data->type_list.next = data->type_list.prev = NULL;
+	initng_list_add(&data->list, &d->head.list);
+
+	if (d->changed)
+		(*d->changed) (d, data->type);
+
+	/* the index is built on the first lookup */
+	if (!d->index || !data->type)
+		return;
+
+	if ((d->index->used + 1) * 2 > d->index->size &&
+	    !lookup(d->index, data->type, FALSE)) {
+		build(d, d->index->size * 2);
+		return;
+	}
+
+	initng_list_add(&data->type_list, lookup(d->index, data->type, TRUE));
+}
@@ -32,4 +32,21 @@
 
 #define IT(x) (type->type == x || type->type == (x + 50))
 
+/*
+ * The per type index of a data_head, an open addressed table of chain
+ * heads keyed on the s_entry pointer. Each chain holds the entries of one
+ * type in the same order as the main list.
+ */
+struct s_data_index {
+	unsigned int size;	/* always a power of two */
+	unsigned int used;
+	struct {
+		s_entry *type;
+		list_t chain;
+	} slot[];
+};
+
+list_t *initng_data_index_chain(data_head * d, s_entry * type);
+void initng_data_index_free(data_head * d);
+
 #endif
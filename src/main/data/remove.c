@@ -31,11 +31,18 @@
  */
 static void dfree(s_data * current)
 {
+	data_head *owner;
+
 	assert(current);
 	assert(current->type);
+	owner = current->owner;
 
 	/* Unlink this entry from any list */
 	initng_list_del(&current->list);
+	initng_list_del(&current->type_list);
+
+	if (owner && owner->changed)
+		(*owner->changed) (owner, current->type);
 
 	/* free variable data */
 	switch (current->type->type) {
@@ -56,7 +63,7 @@ static void dfree(s_data * current)
 	current->vn = NULL;
 
 	/* ok, free the struct */
-	free(current);
+	initng_slab_free(&initng_slab_data, current);
 }
 
 void initng_data_remove_all(data_head * d)
@@ -73,8 +80,14 @@ void initng_data_remove_all(data_head * d)
 		current = NULL;
 	}
 
-	/* make sure its cleared */
-	DATA_HEAD_INIT(d);
+	/* make sure its cleared, but keep the change hook */
+	initng_data_index_free(d);
+	{
+		void (*changed) (data_head *, s_entry *) = d->changed;
+
+		DATA_HEAD_INIT(d);
+		d->changed = changed;
+	}
 }
 
 void initng_data_remove_var(s_entry * type, const char *vn, data_head * d)
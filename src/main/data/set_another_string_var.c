@@ -53,11 +53,11 @@ void initng_data_set_another_string_var(s_entry * type, char *vn,
 		return;
 	}
 
-	current = (s_data *) initng_toolbox_calloc(1, sizeof(s_data));
+	current = (s_data *) initng_slab_alloc(&initng_slab_data);
 	current->type = type;
 	current->t.s = string;
 	current->vn = vn;
 
 	/* add this one */
-	initng_list_add(&(current->list), &d->head.list);
+	initng_data_add(d, current);
 }
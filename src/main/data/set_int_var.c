@@ -55,15 +55,17 @@ void initng_data_set_int_var(s_entry * type, char *vn, data_head * d, int value)
 	current = initng_data_get_next_var(type, vn, d, NULL);
 	if (current) {
 		current->t.i = value;
+		if (current->owner && current->owner->changed)
+			(*current->owner->changed) (current->owner, type);
 		return;
 	}
 
 	/* else create a new one */
-	current = (s_data *) initng_toolbox_calloc(1, sizeof(s_data));
+	current = (s_data *) initng_slab_alloc(&initng_slab_data);
 	current->type = type;
 	current->t.i = value;
 	current->vn = vn;
 
 	/* add this one */
-	initng_list_add(&(current->list), &d->head.list);
+	initng_data_add(d, current);
 }
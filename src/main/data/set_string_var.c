@@ -61,14 +61,16 @@ void initng_data_set_string_var(s_entry * type, char *vn, data_head * d,
 		free(current->t.s);
 		free(vn);
 		current->t.s = string;
+		if (current->owner && current->owner->changed)
+			(*current->owner->changed) (current->owner, type);
 		return;
 	}
 
-	current = (s_data *) initng_toolbox_calloc(1, sizeof(s_data));
+	current = (s_data *) initng_slab_alloc(&initng_slab_data);
 	current->type = type;
 	current->t.s = string;
 	current->vn = vn;
 
 	/* add this one */
-	initng_list_add(&(current->list), &d->head.list);
+	initng_data_add(d, current);
 }
@@ -55,10 +55,10 @@ void initng_data_set_var(s_entry * type, char *vn, data_head * d)
 		return;
 
 	/* allocate the entry */
-	current = (s_data *) initng_toolbox_calloc(1, sizeof(s_data));
+	current = (s_data *) initng_slab_alloc(&initng_slab_data);
 	current->type = type;
 	current->vn = vn;
 
 	/* add this one */
-	initng_list_add(&(current->list), &d->head.list);
+	initng_data_add(d, current);
 }
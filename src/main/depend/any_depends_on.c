@@ -24,34 +24,37 @@
 #include <string.h>
 #include <assert.h>
 
+#include "local.h"
+
 /* check if any service in list, that is starting, running, or stopping
  * is depending on service
  * returns TRUE if any service depends * service
  */
 int initng_depend_any_depends_on(active_db_h * service)
 {
-	active_db_h *current = NULL;
+	active_db_h **list = NULL;
+	int result = FALSE;
+	int len;
+	int i;
 
 	D_("initng_any_depends_on(%s);\n", service->name);
 
-	while_active_db(current) {
-		/* Dont mind stop itself */
-		if (current == service)
-			continue;
-
-		switch (GET_STATE(current)) {
+	len = initng_depend_dependents(service, &list);
+	for (i = 0; i < len && result == FALSE; i++) {
+		switch (GET_STATE(list[i])) {
 		case IS_UP:
 		case IS_STARTING:
 		case IS_STOPPING:
 			/* if current depends on service */
-			if (initng_depend_deep(current, service) == TRUE) {
-				D_("Service %s depends on %s\n", current->name,
-				   service->name);
-				return TRUE;
-			}
+			D_("Service %s depends on %s\n", list[i]->name,
+			   service->name);
+			result = TRUE;
 		}
 	}
 
-	D_("None found depending on %s.\n", service->name);
-	return FALSE;
+	free(list);
+
+	if (result == FALSE)
+		D_("None found depending on %s.\n", service->name);
+	return result;
 }
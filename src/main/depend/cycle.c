@@ -0,0 +1,335 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "local.h"
+
+/*
+ * Circular dependency detection.
+ *
+ * After every change to the graph, the strongly connected components
+ * are looked up with Tarjan's algorithm. Use deps inside a cycle are
+ * broken first, they are only about order: one in every component at a
+ * time, the first by service and dep name, and the components looked up
+ * again, until no cycle has a use dep left. If a cycle is still there,
+ * the services left in it are marked deps_cycle, and
+ * initng_depend_start_dep_met() fails them instead of waiting forever.
+ */
+
+static int dirty = FALSE;
+
+/* per deps_id, only valid during a check */
+static int *index_of;
+static int *low;
+static int *comp;
+static active_db_h **stack;
+static int sp;
+static int counter;
+static int comps;
+
+void initng_depend_cycle_dirty(void)
+{
+	dirty = TRUE;
+}
+
+static int follow(s_dep * edge)
+{
+	if (!edge->to || edge->type == DEP_PROVIDE)
+		return FALSE;
+	if (edge->broken)
+		return FALSE;
+	return TRUE;
+}
+
+static void strong(active_db_h * v)
+{
+	s_dep *edge;
+	int id = v->deps_id;
+	int w;
+
+	index_of[id] = low[id] = ++counter;
+	comp[id] = -1;
+	stack[sp++] = v;
+
+	while_depend_edges(edge, v) {
+		if (!follow(edge))
+			continue;
+
+		w = edge->to->deps_id;
+		if (!index_of[w]) {
+			strong(edge->to);
+			if (low[w] < low[id])
+				low[id] = low[w];
+		} else if (comp[w] < 0 && index_of[w] < low[id]) {
+			/* still on the stack */
+			low[id] = index_of[w];
+		}
+	}
+
+	if (low[id] != index_of[id])
+		return;
+
+	/* v is the root of a component, pop it */
+	do {
+		w = stack[--sp]->deps_id;
+		comp[w] = comps;
+	} while (w != id);
+	comps++;
+}
+
+/* is service in a component with more than itself, or on its own loop */
+static int circular(active_db_h * service)
+{
+	s_dep *edge;
+
+	while_depend_edges(edge, service) {
+		if (follow(edge) &&
+		    comp[edge->to->deps_id] == comp[service->deps_id])
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+static void components(int ids)
+{
+	active_db_h *current = NULL;
+
+	memset(index_of, 0, ids * sizeof(int));
+	sp = 0;
+	counter = 0;
+	comps = 0;
+
+	while_active_db(current) {
+		if (!index_of[current->deps_id])
+			strong(current);
+	}
+}
+
+/*
+ * Find a way from service back to start inside their component, the
+ * services on the way are left in stack[0 .. return value - 1].
+ */
+static int find_cycle(active_db_h * service, active_db_h * start, int depth)
+{
+	s_dep *edge;
+	int len;
+
+	/* reuse index_of as visited marks */
+	index_of[service->deps_id] = -1;
+	stack[depth] = service;
+
+	while_depend_edges(edge, service) {
+		if (!follow(edge) ||
+		    comp[edge->to->deps_id] != comp[start->deps_id])
+			continue;
+
+		if (edge->to == start)
+			return depth + 1;
+
+		if (index_of[edge->to->deps_id] != -1 &&
+		    (len = find_cycle(edge->to, start, depth + 1)))
+			return len;
+	}
+
+	return 0;
+}
+
+static void report(active_db_h * service)
+{
+	active_db_h *current = NULL;
+	char *path = NULL;
+	int len;
+	int i;
+
+	/* a fresh set of marks */
+	while_active_db(current) {
+		if (comp[current->deps_id] == comp[service->deps_id])
+			index_of[current->deps_id] = 0;
+	}
+
+	len = find_cycle(service, service, 0);
+	for (i = 0; i < len; i++)
+		initng_string_mprintf(&path, "%s -> ", stack[i]->name);
+	initng_string_mprintf(&path, "%s", service->name);
+
+	F_("Circular dependency, can't start: %s\n", path);
+	free(path);
+}
+
+/* the order use deps are broken in, so it is the same every boot */
+static int sooner(s_dep * a, s_dep * b)
+{
+	int cmp = strcmp(a->from->name, b->from->name);
+
+	if (cmp)
+		return cmp < 0;
+	return strcmp(a->name, b->name) < 0;
+}
+
+/*
+ * Break one use dep inside every cycle left, returns FALSE when there
+ * were none.
+ */
+static int break_one(s_dep ** pick)
+{
+	active_db_h *current = NULL;
+	s_dep *edge;
+	int found = FALSE;
+	int c;
+
+	memset(pick, 0, comps * sizeof(s_dep *));
+
+	/* every edge inside a component is on a cycle */
+	while_active_db(current) {
+		while_depend_edges(edge, current) {
+			if (edge->type != DEP_USE || !follow(edge))
+				continue;
+
+			c = comp[current->deps_id];
+			if (comp[edge->to->deps_id] != c)
+				continue;
+
+			if (!pick[c] || sooner(edge, pick[c]))
+				pick[c] = edge;
+		}
+	}
+
+	for (c = 0; c < comps; c++) {
+		if (pick[c]) {
+			pick[c]->broken = TRUE;
+			found = TRUE;
+		}
+	}
+
+	return found;
+}
+
+void initng_depend_cycle_check(void)
+{
+	active_db_h *current = NULL;
+	s_dep *edge;
+	s_dep **pick;
+	int *was;
+	int edges = 0;
+	int ids;
+	int i;
+	int changed = FALSE;
+
+	if (!dirty)
+		return;
+	dirty = FALSE;
+
+	ids = initng_depend_reach_ids();
+	if (!ids)
+		return;
+
+	index_of = initng_toolbox_calloc(ids, sizeof(int));
+	low = initng_toolbox_calloc(ids, sizeof(int));
+	comp = initng_toolbox_calloc(ids, sizeof(int));
+	stack = initng_toolbox_calloc(ids, sizeof(active_db_h *));
+	pick = initng_toolbox_calloc(ids, sizeof(s_dep *));
+
+	/* start over from the whole graph, remembering what was broken */
+	while_active_db(current) {
+		edges += current->deps_len;
+	}
+	was = initng_toolbox_calloc(edges ? edges : 1, sizeof(int));
+
+	i = 0;
+	while_active_db(current) {
+		while_depend_edges(edge, current) {
+			was[i++] = edge->broken;
+			edge->broken = FALSE;
+		}
+	}
+
+	/* break the use deps needed to undo the cycles, one at a time */
+	do {
+		components(ids);
+	} while (break_one(pick));
+
+	i = 0;
+	while_active_db(current) {
+		while_depend_edges(edge, current) {
+			int brk = edge->broken;
+
+			if (brk == was[i++])
+				continue;
+
+			if (brk) {
+				W_("Circular dependency, ignoring that %s "
+				   "uses %s.\n", current->name, edge->name);
+
+				/* no longer waiting for it either */
+				if (edge->waiting) {
+					edge->waiting = FALSE;
+					if (--current->deps_unmet == 0)
+						initng_interrupt_ready(current);
+				}
+			}
+
+			changed = TRUE;
+		}
+	}
+
+	free(was);
+	free(pick);
+
+	/* whatever is still circular can't be started, low is done with,
+	 * it marks the components reported */
+	memset(low, 0, ids * sizeof(int));
+
+	while_active_db(current) {
+		int cycle = circular(current);
+
+		if (cycle == current->deps_cycle)
+			continue;
+
+		current->deps_cycle = cycle;
+		if (!cycle)
+			continue;
+
+		/* one report for every cycle */
+		if (!low[comp[current->deps_id]]) {
+			low[comp[current->deps_id]] = TRUE;
+			report(current);
+		}
+
+		/* let it fail, if it is waiting */
+		if (current->deps_unmet)
+			initng_interrupt_ready(current);
+	}
+
+	free(index_of);
+	free(low);
+	free(comp);
+	free(stack);
+
+	/* the broken edges change what reaches what */
+	if (changed) {
+		initng_depend_reach_changed();
+		dirty = FALSE;
+	}
+}
@@ -26,16 +26,11 @@
 
 #include "local.h"
 
-/* standard dep check , does service depends on check? */
-int dep_on(active_db_h * service, active_db_h * check)
+/* compare the deps data by name, for services outside the graph */
+static int dep_on_name(active_db_h * service, active_db_h * check)
 {
 	s_data *current = NULL;
 
-	assert(service);
-	assert(service->name);
-	assert(check);
-	assert(check->name);
-
 	/* walk all possible entrys, use get_next with NULL because we want
 	 * both REQUIRE and NEED */
 	while ((current = get_next(NULL, service, current))) {
@@ -55,3 +50,28 @@ int dep_on(active_db_h * service, active_db_h * check)
 	/* No, it did not */
 	return FALSE;
 }
+
+/* standard dep check , does service depends on check? */
+int dep_on(active_db_h * service, active_db_h * check)
+{
+	s_dep *edge;
+
+	assert(service);
+	assert(service->name);
+	assert(check);
+	assert(check->name);
+
+	/* only registered services have edges */
+	if (!service->list.next || !check->list.next)
+		return dep_on_name(service, check);
+
+	initng_depend_graph_sync();
+
+	while_depend_edges(edge, service) {
+		if (DEP_IS_DEPEND(edge) && edge->to == check)
+			return TRUE;
+	}
+
+	/* No, it did not */
+	return FALSE;
+}
@@ -44,8 +44,8 @@ int initng_depend(active_db_h * service, active_db_h * check)
 	if (dep_on(service, check) == TRUE)
 		return TRUE;
 
-	/* run the global module dep check */
-	{
+	/* run the global module dep check, if any module listens */
+	if (DEP_ON_HOOKED()) {
 		s_event event;
 		s_event_dep_on_data data;
 
@@ -24,54 +24,61 @@
 #include <string.h>
 #include <assert.h>
 
+#include "local.h"
+
 /*
- * A deeper deep-find.
- * Logic, we wanna make sure that depend check in a deeper level.
- * if daemon/smbd -> daemon/samba -> system/checkroot -> system/initial.
- * So should initng_depend_deep(daemon/smbd, system/initial) == TRUE
- *
- * Summary, does service depends on check?
+ * The slow walk, asking initng_depend() about every pair, for when
+ * modules add deps the graph does not know. Every service is visited
+ * once, so circular deps end the walk too.
  */
-static int initng_depend_deep2(active_db_h * service, active_db_h * check,
-			       int *stack);
-
-int initng_depend_deep(active_db_h * service, active_db_h * check)
-{
-	int stack = 0;
-
-	return initng_depend_deep2(service, check, &stack);
-}
-
-static int initng_depend_deep2(active_db_h * service, active_db_h * check,
-			       int *stack)
+static int deep_walk(active_db_h * service, active_db_h * check,
+		     unsigned int stamp)
 {
 	active_db_h *current = NULL;
-	int result = FALSE;
 
-	/* avoid cirular */
-	if (current == service)
-		return FALSE;
+	service->deps_visit = stamp;
 
 	/* if service depends on check, it also dep_on_deep's on check
 	 * this serves as an exit from the recursion */
 	if (initng_depend(service, check))
 		return TRUE;
 
-	/* in case there is a circular dependency, break after 10 levels of
-	 * recursion */
-	if (++(*stack) > 10)
-		return FALSE;
-
 	/* loop over all services, if service depends on current, recursively
 	 * check if current may depend (deep) on check */
 	while_active_db(current) {
-		if (initng_depend(service, current)) {
-			if ((result =
-			     initng_depend_deep2(current, check, stack)))
-				break;
-		}
+		if (current->deps_visit == stamp)
+			continue;
+
+		if (initng_depend(service, current) &&
+		    deep_walk(current, check, stamp))
+			return TRUE;
 	}
 
-	/* return with the result found at last */
-	return result;
+	return FALSE;
+}
+
+/*
+ * A deeper deep-find.
+ * Logic, we wanna make sure that depend check in a deeper level.
+ * if daemon/smbd -> daemon/samba -> system/checkroot -> system/initial.
+ * So should initng_depend_deep(daemon/smbd, system/initial) == TRUE
+ *
+ * Summary, does service depends on check?
+ */
+int initng_depend_deep(active_db_h * service, active_db_h * check)
+{
+	assert(service);
+	assert(check);
+
+	/* it can never depend on itself */
+	if (service == check)
+		return FALSE;
+
+	/* module deps and unregistered services are only seen by the
+	 * slow walk */
+	if (DEP_ON_HOOKED() || !service->list.next || !check->list.next)
+		return deep_walk(service, check, initng_depend_graph_stamp());
+
+	initng_depend_graph_sync();
+	return initng_depend_reaches(service, check);
 }
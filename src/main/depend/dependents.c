@@ -0,0 +1,100 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+
+#include <stdio.h>
+#include <stdlib.h>		/* free() exit() */
+#include <string.h>
+#include <assert.h>
+
+#include "local.h"
+
+static void add(active_db_h *** list, int *len, int *size,
+		active_db_h * service)
+{
+	if (*len == *size) {
+		*size = *size ? *size * 2 : 8;
+		*list = initng_toolbox_realloc(*list, *size *
+					       sizeof(active_db_h *));
+	}
+	(*list)[(*len)++] = service;
+}
+
+/*
+ * Collect every service depending deep on service into a newly
+ * allocated list, the caller frees it. Returns the number found.
+ */
+int initng_depend_dependents(active_db_h * service, active_db_h *** list)
+{
+	active_db_h *current = NULL;
+	s_dep *edge;
+	unsigned int stamp;
+	int len = 0;
+	int size = 0;
+	int next = 0;
+	int i;
+
+	assert(service);
+	assert(list);
+
+	*list = NULL;
+
+	/* module deps and unregistered services are only seen by
+	 * initng_depend_deep() */
+	if (DEP_ON_HOOKED() || !service->list.next) {
+		while_active_db(current) {
+			/* Dont mind service itself */
+			if (current == service)
+				continue;
+
+			if (initng_depend_deep(current, service) == TRUE)
+				add(list, &len, &size, current);
+		}
+
+		return len;
+	}
+
+	initng_depend_graph_sync();
+
+	/*
+	 * Walk the reverse edges breadth first, the list found so far is
+	 * the queue, so this only touches the dependents.
+	 */
+	stamp = initng_depend_graph_stamp();
+	service->deps_visit = stamp;
+	current = service;
+
+	for (;;) {
+		while_depend_redges(i, edge, current) {
+			if (!DEP_IS_DEPEND(edge) ||
+			    edge->from->deps_visit == stamp)
+				continue;
+
+			edge->from->deps_visit = stamp;
+			add(list, &len, &size, edge->from);
+		}
+
+		if (next == len)
+			break;
+		current = (*list)[next++];
+	}
+
+	return len;
+}
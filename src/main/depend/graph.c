@@ -0,0 +1,262 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "local.h"
+
+#define PENDING_BUCKETS 64
+
+/* unresolved edges, hashed on the name they point at */
+static list_t pending[PENDING_BUCKETS];
+
+/* services whose deps data changed since their edges were built */
+static list_t dirty = LIST_HEAD_INIT(dirty);
+
+static list_t *bucket(hash_t hash)
+{
+	list_t *head = &pending[hash % PENDING_BUCKETS];
+
+	/* buckets are set up the first time they are used */
+	if (!head->next)
+		initng_list_init(head);
+
+	return head;
+}
+
+static e_dep edge_type(s_entry * type)
+{
+	if (type == &REQUIRE)
+		return DEP_REQUIRE;
+	if (type == &NEED)
+		return DEP_NEED;
+	if (type == &USE)
+		return DEP_USE;
+	if (type && type->name && strcmp(type->name, "provide") == 0)
+		return DEP_PROVIDE;
+	return 0;
+}
+
+static void link_reverse(s_dep * edge, active_db_h * to)
+{
+	edge->to = to;
+	initng_depend_reach_changed();
+
+	if (to->rdeps_len == to->rdeps_size) {
+		to->rdeps_size = to->rdeps_size ? to->rdeps_size * 2 : 4;
+		to->rdeps = initng_toolbox_realloc(to->rdeps,
+						   to->rdeps_size *
+						   sizeof(s_dep *));
+	}
+	to->rdeps[to->rdeps_len++] = edge;
+}
+
+static void unlink_reverse(s_dep * edge)
+{
+	active_db_h *to = edge->to;
+	int i;
+
+	for (i = 0; i < to->rdeps_len; i++) {
+		if (to->rdeps[i] == edge) {
+			to->rdeps[i] = to->rdeps[--to->rdeps_len];
+			break;
+		}
+	}
+
+	edge->to = NULL;
+	initng_depend_reach_changed();
+}
+
+static void resolve(s_dep * edge)
+{
+	active_db_h *to = initng_active_db_find_by_name(edge->name);
+
+	if (to)
+		link_reverse(edge, to);
+	else
+		initng_list_add(&edge->pending, bucket(edge->hash));
+}
+
+static void free_edges(active_db_h * service)
+{
+	int i;
+
+	for (i = 0; i < service->deps_len; i++) {
+		s_dep *edge = &service->deps[i];
+
+		if (edge->to)
+			unlink_reverse(edge);
+		else
+			initng_list_del(&edge->pending);
+		free(edge->name);
+	}
+
+	free(service->deps);
+	service->deps = NULL;
+	service->deps_len = 0;
+}
+
+static void build_edges(active_db_h * service)
+{
+	s_data *current = NULL;
+	int count = 0;
+
+	/* count them first, edges must not move once linked */
+	while ((current = get_next(NULL, service, current))) {
+		if (edge_type(current->type) && current->t.s)
+			count++;
+	}
+
+	if (!count)
+		return;
+
+	service->deps = initng_toolbox_calloc(count, sizeof(s_dep));
+
+	while ((current = get_next(NULL, service, current))) {
+		s_dep *edge;
+
+		if (!edge_type(current->type) || !current->t.s)
+			continue;
+
+		edge = &service->deps[service->deps_len++];
+		edge->type = edge_type(current->type);
+		edge->name = initng_toolbox_strdup(current->t.s);
+		edge->hash = initng_hash_str(edge->name);
+		edge->from = service;
+		resolve(edge);
+	}
+}
+
+/*
+ * Add a newly registered service to the graph, and resolve the edges
+ * waiting for its name.
+ */
+void initng_depend_graph_add(active_db_h * service)
+{
+	s_dep *edge, *safe = NULL;
+
+	assert(service);
+
+	initng_depend_reach_add(service);
+	build_edges(service);
+
+	initng_list_foreach_safe(edge, safe, bucket(service->name_hash),
+				 pending) {
+		if (edge->hash != service->name_hash ||
+		    strcmp(edge->name, service->name) != 0)
+			continue;
+
+		initng_list_del(&edge->pending);
+		link_reverse(edge, service);
+	}
+}
+
+/*
+ * Remove an unregistered service from the graph, edges pointing at it
+ * become unresolved again, and are not waited on any longer.
+ */
+void initng_depend_graph_del(active_db_h * service)
+{
+	assert(service);
+
+	while (service->rdeps_len > 0) {
+		s_dep *edge = service->rdeps[0];
+
+		unlink_reverse(edge);
+		initng_list_add(&edge->pending, bucket(edge->hash));
+
+		/* check it again, without this one */
+		if (edge->waiting) {
+			edge->waiting = FALSE;
+			if (--edge->from->deps_unmet == 0)
+				initng_interrupt_ready(edge->from);
+		}
+	}
+
+	free(service->rdeps);
+	service->rdeps = NULL;
+	service->rdeps_size = 0;
+
+	initng_depend_unschedule(service);
+	free_edges(service);
+	initng_list_del(&service->deps_dirty);
+	initng_depend_reach_del(service);
+}
+
+/*
+ * Called on data changes of every active_db entry, marks the edges of the
+ * service for a rebuild when its deps change.
+ */
+void initng_depend_graph_changed(data_head * d, s_entry * type)
+{
+	active_db_h *service = initng_list_entry(d, active_db_h, data);
+
+	if (!edge_type(type))
+		return;
+
+	/* only registered services are in the graph */
+	if (!service->list.next)
+		return;
+
+	initng_list_del(&service->deps_dirty);
+	initng_list_add_tail(&service->deps_dirty, &dirty);
+}
+
+void initng_depend_graph_sync(void)
+{
+	while (!initng_list_isempty(&dirty)) {
+		active_db_h *service = initng_list_entry(dirty.next,
+							 active_db_h,
+							 deps_dirty);
+
+		initng_list_del(&service->deps_dirty);
+
+		/* the counted edges are going away, check it again */
+		if (service->deps_unmet) {
+			service->deps_unmet = 0;
+			initng_interrupt_ready(service);
+		}
+
+		free_edges(service);
+		build_edges(service);
+	}
+
+	initng_depend_cycle_check();
+}
+
+unsigned int initng_depend_graph_stamp(void)
+{
+	static unsigned int stamp = 0;
+
+	/* on wrap around, forget every old stamp */
+	if (++stamp == 0) {
+		active_db_h *current = NULL;
+
+		while_active_db(current) {
+			current->deps_visit = 0;
+		}
+		stamp = 1;
+	}
+
+	return stamp;
+}
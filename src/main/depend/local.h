@@ -22,4 +22,28 @@
 
 int dep_on(active_db_h * service, active_db_h * check);
 
+/* a fresh deps_visit stamp for a walk over the graph */
+unsigned int initng_depend_graph_stamp(void);
+
+/* the cached deep deps, see reach.c */
+void initng_depend_reach_add(active_db_h * service);
+void initng_depend_reach_del(active_db_h * service);
+void initng_depend_reach_changed(void);
+int initng_depend_reaches(active_db_h * service, active_db_h * check);
+int initng_depend_reach_ids(void);
+
+/* circular dep detection, see cycle.c */
+void initng_depend_cycle_dirty(void);
+void initng_depend_cycle_check(void);
+
+/* count edge in the unmet start deps of its service, see sched.c */
+void initng_depend_wait_edge(s_dep * edge);
+
+/* every service depending, directly or not, on service */
+int initng_depend_dependents(active_db_h * service, active_db_h *** list);
+
+/* modules hooking EVENT_DEP_ON can add edges the graph does not know */
+#define DEP_ON_HOOKED() (EVENT_DEP_ON.hooks.list.next && \
+	!initng_list_isempty(&EVENT_DEP_ON.hooks.list))
+
 #endif
@@ -0,0 +1,149 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "local.h"
+
+#define WORD_BITS (sizeof(unsigned long) * 8)
+
+/*
+ * Every service in the graph owns a dense id, and a row of bits with the
+ * ids of every service it depends on, directly or not. Rows are computed
+ * when first asked for, and all of them are dropped by bumping the
+ * generation whenever an edge comes or goes.
+ */
+static active_db_h **by_id = NULL;
+static int by_id_len = 0;
+static int by_id_size = 0;
+
+/* never 0, so a zeroed row is never valid */
+static unsigned int generation = 1;
+
+#define ROW_WORDS ((by_id_size + WORD_BITS - 1) / WORD_BITS)
+#define ROW_SET(row, id) ((row)[(id) / WORD_BITS] |= 1UL << ((id) % WORD_BITS))
+#define ROW_ISSET(row, id) ((row)[(id) / WORD_BITS] & (1UL << ((id) % WORD_BITS)))
+#define ROW_VALID(service) ((service)->deps_reach && \
+	(service)->deps_reach_gen == generation)
+
+void initng_depend_reach_changed(void)
+{
+	int i;
+
+	/* on wrap around, an old row could look valid again */
+	if (++generation == 0) {
+		for (i = 0; i < by_id_len; i++)
+			by_id[i]->deps_reach_gen = 0;
+		generation = 1;
+	}
+
+	/* and look for circular deps again */
+	initng_depend_cycle_dirty();
+}
+
+int initng_depend_reach_ids(void)
+{
+	return by_id_len;
+}
+
+void initng_depend_reach_add(active_db_h * service)
+{
+	int i;
+
+	if (by_id_len == by_id_size) {
+		by_id_size = by_id_size ? by_id_size * 2 : 64;
+		by_id = initng_toolbox_realloc(by_id, by_id_size *
+					       sizeof(active_db_h *));
+
+		/* every row is too short now */
+		for (i = 0; i < by_id_len; i++) {
+			free(by_id[i]->deps_reach);
+			by_id[i]->deps_reach = NULL;
+		}
+	}
+
+	service->deps_id = by_id_len;
+	by_id[by_id_len++] = service;
+	initng_depend_reach_changed();
+}
+
+void initng_depend_reach_del(active_db_h * service)
+{
+	assert(by_id[service->deps_id] == service);
+
+	/* move the last one into the hole, rows are dropped anyway */
+	by_id[service->deps_id] = by_id[--by_id_len];
+	by_id[service->deps_id]->deps_id = service->deps_id;
+
+	free(service->deps_reach);
+	service->deps_reach = NULL;
+	initng_depend_reach_changed();
+}
+
+static void fill(unsigned long *row, active_db_h * service)
+{
+	s_dep *edge;
+	int i;
+
+	while_depend_edges(edge, service) {
+		if (!DEP_IS_DEPEND(edge) || !edge->to ||
+		    ROW_ISSET(row, edge->to->deps_id))
+			continue;
+
+		ROW_SET(row, edge->to->deps_id);
+
+		/* a complete row covers everything below it */
+		if (ROW_VALID(edge->to)) {
+			for (i = 0; i < (int)ROW_WORDS; i++)
+				row[i] |= edge->to->deps_reach[i];
+			continue;
+		}
+
+		fill(row, edge->to);
+	}
+}
+
+/*
+ * Does service depend on check, at any depth? Both have to be in the
+ * graph, and the graph synced.
+ */
+int initng_depend_reaches(active_db_h * service, active_db_h * check)
+{
+	assert(service->list.next);
+	assert(check->list.next);
+
+	if (!ROW_VALID(service)) {
+		if (!service->deps_reach)
+			service->deps_reach =
+			    initng_toolbox_calloc(ROW_WORDS,
+						  sizeof(unsigned long));
+		else
+			memset(service->deps_reach, 0,
+			       ROW_WORDS * sizeof(unsigned long));
+
+		fill(service->deps_reach, service);
+		service->deps_reach_gen = generation;
+	}
+
+	return ROW_ISSET(service->deps_reach, check->deps_id) ? TRUE : FALSE;
+}
@@ -0,0 +1,103 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "local.h"
+
+/*
+ * The start scheduler.
+ *
+ * When initng_depend_start_dep_met() finds deps that are not up yet, it
+ * flags their edges and counts them in deps_unmet, instead of polling.
+ * Each dep coming up counts its waiters down, and a waiter reaching zero
+ * is queued for its state interrupt handler, that checks its deps once
+ * more and starts it. A dep going anywhere else than up wakes its
+ * waiters right away, so a failed dep fails them without delay.
+ */
+
+void initng_depend_wait_edge(s_dep * edge)
+{
+	assert(edge);
+
+	if (edge->waiting)
+		return;
+
+	edge->waiting = TRUE;
+	edge->from->deps_unmet++;
+}
+
+/*
+ * Forget what service was counting, it is checked from scratch the next
+ * time start_dep_met is called.
+ */
+void initng_depend_unschedule(active_db_h * service)
+{
+	s_dep *edge;
+
+	assert(service);
+
+	if (!service->deps_unmet)
+		return;
+
+	while_depend_edges(edge, service) {
+		edge->waiting = FALSE;
+	}
+
+	service->deps_unmet = 0;
+}
+
+void initng_depend_state_changed(active_db_h * dep)
+{
+	s_dep *edge;
+	int i;
+
+	assert(dep);
+
+	while_depend_redges(i, edge, dep) {
+		if (!edge->waiting)
+			continue;
+
+		switch (GET_STATE(dep)) {
+		/* still on its way */
+		case IS_NEW:
+		case IS_STARTING:
+			break;
+
+		case IS_UP:
+			edge->waiting = FALSE;
+			if (--edge->from->deps_unmet == 0) {
+				D_("All deps of %s are up, ready.\n",
+				   edge->from->name);
+				initng_interrupt_ready(edge->from);
+			}
+			break;
+
+		/* failed, stopped or worse, let it check again */
+		default:
+			initng_depend_unschedule(edge->from);
+			initng_interrupt_ready(edge->from);
+			break;
+		}
+	}
+}
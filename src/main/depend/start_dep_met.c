@@ -24,6 +24,8 @@
 #include <string.h>
 #include <assert.h>
 
+#include "local.h"
+
 /*
  * This will check with plug-ins if dependencies for start this is met.
  * If this returns FALSE deps are not met yet, try later.
@@ -32,51 +34,49 @@
 int initng_depend_start_dep_met(active_db_h * service, int verbose)
 {
 	active_db_h *dep = NULL;
-	s_data *current = NULL;
-	int count = 0;
+	s_dep *edge;
 
 	assert(service);
 	assert(service->name);
 
-	/* walk all possible entrys, use get_next with NULL because we want
-	 * REQUIRE, NEED and USE */
-	while ((current = get_next(NULL, service, current))) {
-		/* only intreseted in two types */
-		if (current->type != &REQUIRE && current->type != &NEED &&
-		    current->type != &USE)
-			continue;
+	initng_depend_graph_sync();
 
-		/* to be sure */
-		if (!current->t.s)
-			continue;
+	/* count the unmet deps from scratch */
+	initng_depend_unschedule(service);
 
-		/* this is a cache, that meens that calling this function over
-		 * and over again, we dont make two checks on same entry */
-		count++;
-		if (service->depend_cache >= count) {
-			D_("Dep %s is ok allredy for %s.\n", current->t.s,
-			   service->name);
-			continue;
+	/* it would wait for itself forever, cycle.c has said why */
+	if (service->deps_cycle) {
+		if (verbose) {
+			F_("Could not start service %s because it is in a "
+			   "circular dependency.\n", service->name);
 		}
+		return FAIL;
+	}
+
+	/* walk the edges, we want REQUIRE, NEED and USE */
+	while_depend_edges(edge, service) {
+		if (!DEP_IS_DEPEND(edge))
+			continue;
 
 		/* tell the user what we got */
 #ifdef DEBUG
-		if (current->type == &REQUIRE)
-			D_(" %s requires %s\n", service->name, current->t.s);
-		else if (current->type == &NEED)
-			D_(" %s needs %s\n", service->name, current->t.s);
-		else if (current->type == &USE)
-			D_(" %s uses %s\n", service->name, current->t.s);
+		if (edge->type == DEP_REQUIRE)
+			D_(" %s requires %s\n", service->name, edge->name);
+		else if (edge->type == DEP_NEED)
+			D_(" %s needs %s\n", service->name, edge->name);
+		else if (edge->type == DEP_USE)
+			D_(" %s uses %s\n", service->name, edge->name);
 #endif
 
 		/* look if it exits already */
-		if (!(dep = initng_active_db_find_by_name(current->t.s))) {
-			if (current->type == &USE) {
+		if (!(dep = edge->to)) {
+			if (edge->type == DEP_USE) {
 				/* if its not yet found, and i dont care */
 				continue;
-			} else if (current->type == &REQUIRE) {
+			} else if (edge->type == DEP_REQUIRE) {
 				F_("%s required dep \"%s\" could not start!\n",
-				   service->name, current->t.s);
+				   service->name, edge->name);
+				initng_depend_unschedule(service);
 				initng_common_mark_service(service,
 							   &REQ_NOT_FOUND);
 				/* if its not yet found, this dep is not reached */
@@ -84,7 +84,8 @@ int initng_depend_start_dep_met(active_db_h * service, int verbose)
 			} else {	/* NEED */
 				/* if its not yet found, this dep is not
 				 * reached */
-				return FALSE;
+				initng_depend_wait_edge(edge);
+				continue;
 			}
 		}
 
@@ -96,7 +97,8 @@ int initng_depend_start_dep_met(active_db_h * service, int verbose)
 				   "depends on service %s that is still "
 				   "starting.\n", service->name, dep->name);
 			}
-			return FALSE;
+			initng_depend_wait_edge(edge);
+			continue;
 
 		/* if service failed, return that */
 		case IS_FAILED:
@@ -105,16 +107,19 @@ int initng_depend_start_dep_met(active_db_h * service, int verbose)
 				   "depends on service %s that is failed.\n",
 				   service->name, dep->name);
 			}
+			initng_depend_unschedule(service);
 			return FAIL;
 
 		/* if its this fresh, we dont do anything */
 		case IS_NEW:
-			return FALSE;
+			initng_depend_wait_edge(edge);
+			continue;
 
 		/* if its marked down, and not starting, start it */
 		case IS_DOWN:
 			initng_handler_start_service(dep);
-			return FALSE;
+			initng_depend_wait_edge(edge);
+			continue;
 
 		/* if its not starting or up, return FAIL */
 		case IS_UP: break;
@@ -122,15 +127,22 @@ int initng_depend_start_dep_met(active_db_h * service, int verbose)
 			F_("Could not start service %s because it depends on "
 			   "service %s has state %s\n", service->name,
 			   dep->name, dep->current_state->name);
-			return FALSE;
+			initng_depend_wait_edge(edge);
+			continue;
 		}
 
 		/* GOT HERE MEENS THAT ITS OK */
-		service->depend_cache = count;
-		D_("Dep %s is ok for %s.\n", current->t.s, service->name);
+		D_("Dep %s is ok for %s.\n", edge->name, service->name);
 		/* continue; */
 	}
 
+	/* the deps coming up will count this down, and queue it again */
+	if (service->deps_unmet) {
+		D_("%s is waiting for %i deps.\n", service->name,
+		   service->deps_unmet);
+		return FALSE;
+	}
+
 	/* run the global module dep check */
 	{
 		s_event event;
@@ -146,13 +158,14 @@ int initng_depend_start_dep_met(active_db_h * service, int verbose)
 				   service->name);
 			}
 
+			/* the module can wait for anything, recheck on
+			 * every change, unless it holds the service */
+			if (!service->wait.next)
+				initng_interrupt_wait_all(service);
 			return FALSE;
 		}
 	}
 
 	D_("dep met for %s\n", service->name);
-
-	/* reset the count cache */
-	service->depend_cache = 0;
 	return TRUE;
 }
@@ -30,8 +30,7 @@
  */
 int initng_depend_start_deps(active_db_h * service)
 {
-	active_db_h *dep = NULL;
-	s_data *current = NULL;
+	s_dep *edge;
 
 	assert(service);
 	assert(service->name);
@@ -39,51 +38,46 @@ int initng_depend_start_deps(active_db_h * service)
 	D_("initng_depend_start_deps(%s);\n", service->name);
 #endif
 
-	/* walk all possible entrys, use get_next with NULL becouse we want
-	 * both REQUIRE and NEED
-	 */
-	while ((current = get_next(NULL, service, current))) {
-		/* only intreseted in two types */
-		if (current->type != &REQUIRE && current->type != &NEED)
-			continue;
+	initng_depend_graph_sync();
 
-		/* to be sure */
-		if (!current->t.s)
+	/* walk the edges, we want both REQUIRE and NEED */
+	while_depend_edges(edge, service) {
+		/* only intreseted in two types */
+		if (edge->type != DEP_REQUIRE && edge->type != DEP_NEED)
 			continue;
 
 		/* tell the user what we got */
 		D_(" %s %s %s\n", service->name,
-		   current->type == &REQUIRE ? "requires" : "needs",
-		   current->t.s);
+		   edge->type == DEP_REQUIRE ? "requires" : "needs",
+		   edge->name);
 
 		/* look if it exits already */
-		dep = initng_active_db_find_by_name(current->t.s);
-		if (dep) {
-			D_("No need to LOAD \"%s\" == \"%s\", state %s it is "
-			   "already loaded!\n", current->t.s, dep->name,
-			   dep->current_state->name);
+		if (edge->to) {
+			D_("No need to LOAD \"%s\", state %s it is already "
+			   "loaded!\n", edge->name,
+			   edge->to->current_state->name);
 			/* start the service if its down */
-			if (GET_STATE(dep) == IS_DOWN) {
+			if (GET_STATE(edge->to) == IS_DOWN) {
 				D_("Service %s is down, starting.\n",
-				   dep->name);
-				initng_handler_start_service(dep);
+				   edge->to->name);
+				initng_handler_start_service(edge->to);
 			}
 			continue;
 		}
 
 		D_("Starting new_service becouse not found: %s\n",
-		   current->t.s);
+		   edge->name);
 		/* if we where not succeded to start this new one */
-		if (!initng_handler_start_new_service_named(current->t.s)) {
+		if (!initng_handler_start_new_service_named(edge->name)) {
 			/* if its NEED */
-			if (current->type == &NEED) {
+			if (edge->type == DEP_NEED) {
 				D_("service \"%s\" needs service \"%s\", that "
 				   "could not be found!\n", service->name,
-				   current->t.s);
+				   edge->name);
 				continue;
 			} else {	/* REQUIRE */
 				F_("%s required dep \"%s\" could not start!\n",
-				   service->name, current->t.s);
+				   service->name, edge->name);
 				initng_common_mark_service(service,
 							   &REQ_NOT_FOUND);
 				return FALSE;
@@ -24,6 +24,42 @@
 #include <string.h>
 #include <assert.h>
 
+#include "local.h"
+
+/*
+ * Is currentA, a service depending on the one stopping, still keeping
+ * it up? TRUE while currentA is up or on its way, FALSE once it is
+ * down, failed, or only waiting for its start deps.
+ */
+static int still_needed(active_db_h * currentA)
+{
+	switch (GET_STATE(currentA)) {
+	/* if its done, this is perfect */
+	case IS_DOWN:
+		return FALSE;
+
+	/* If the dep is failed, continue */
+	case IS_FAILED:
+		return FALSE;
+
+	/* BIG TODO.
+	 * This is not correct, but if we wait for a service that is
+	 * starting to stop, and that service is waiting for this
+	 * service to start, until it starts, makes a deadlock.
+	 *
+	 * Asuming that STARTING services WAITING_FOR_START_DEP are
+	 * down for now.
+	 */
+	case IS_STARTING:
+		if (strstr(currentA->current_state->name,
+			   "WAITING_FOR_START_DEP"))
+			return FALSE;
+		break;
+	}
+
+	return TRUE;
+}
+
 /*
  * This will check with plug-ins if dependencies for stop is met.
  * If this returns FALSE deps for stopping are not met, try again later.
@@ -32,55 +68,45 @@
 int initng_depend_stop_dep_met(active_db_h * service, int verbose)
 {
 	active_db_h *currentA = NULL;
-	int count = 0;
+	s_dep *edge;
+	int i;
 
 	assert(service);
 
+	initng_depend_graph_sync();
+
 	/*
 	 * Check so all deps, that needs service, is down.
 	 * if there are services depending on this one still running,
 	 * return false and still try.
 	 */
-	while_active_db(currentA) {
-		count++;
-		if (service->depend_cache >= count)
+	while_depend_redges(i, edge, service) {
+		if (!DEP_IS_DEPEND(edge) || !still_needed(edge->from))
 			continue;
 
-		/* temporary increase depend_cache - will degrese before
-		 * reutrn (FALSE) */
-		service->depend_cache++;
-
-		if (currentA == service)
-			continue;
-
-		/* Does service depends on current ?? */
-		if (initng_depend(currentA, service) == FALSE)
-			continue;
+		currentA = edge->from;
+		break;
+	}
 
-		switch (GET_STATE(currentA)) {
-		/* if its done, this is perfect */
-		case IS_DOWN:
-			continue;
+	/* modules may add deps the edges do not know */
+	if (!currentA && DEP_ON_HOOKED()) {
+		active_db_h *current = NULL;
 
-		/* If the dep is failed, continue */
-		case IS_FAILED:
-			continue;
+		while_active_db(current) {
+			if (current == service)
+				continue;
 
-		/* BIG TODO.
-		 * This is not correct, but if we wait for a service that is
-		 * starting to stop, and that service is waiting for this
-		 * service to start, until it starts, makes a deadlock.
-		 *
-		 * Asuming that STARTING services WAITING_FOR_START_DEP are
-		 * down for now.
-		 */
-		case IS_STARTING:
-			if (strstr(currentA->current_state->name,
-				   "WAITING_FOR_START_DEP"))
+			/* Does service depends on current ?? */
+			if (initng_depend(current, service) == FALSE ||
+			    !still_needed(current))
 				continue;
+
+			currentA = current;
 			break;
 		}
+	}
 
+	if (currentA) {
 #ifdef DEBUG
 		/* else RETURN */
 		if (verbose)
@@ -92,7 +118,7 @@ int initng_depend_stop_dep_met(active_db_h * service, int verbose)
 #endif
 
 		/* no, the dependency are not met YET */
-		service->depend_cache--;
+		initng_interrupt_wait_for(service, currentA->name);
 		return FALSE;
 	}
 
@@ -111,10 +137,12 @@ int initng_depend_stop_dep_met(active_db_h * service, int verbose)
 				   service->name);
 			}
 
+			/* the module can wait for anything, recheck on
+			 * every change */
+			initng_interrupt_wait_all(service);
 			return FALSE;
 		}
 	}
 
-	service->depend_cache = 0;
 	return TRUE;
 }
@@ -24,21 +24,21 @@
 #include <string.h>
 #include <assert.h>
 
+#include "local.h"
+
 int initng_depend_stop_deps(active_db_h * service)
 {
-	active_db_h *current = NULL;
-	active_db_h *safe = NULL;
+	active_db_h **list = NULL;
+	int len;
+	int i;
 
-	/* also stop all service depending on service_to_stop */
-	while_active_db_safe(current, safe) {
-		/* Dont mind stop itself */
-		if (current == service)
-			continue;
+	/* collect them first, handlers may change the graph */
+	len = initng_depend_dependents(service, &list);
 
-		/* if current depends on the one we are stopping */
-		if (initng_depend_deep(current, service) == TRUE)
-			initng_handler_stop_service(current);
-	}
+	/* also stop all service depending on service_to_stop */
+	for (i = 0; i < len; i++)
+		initng_handler_stop_service(list[i]);
 
+	free(list);
 	return TRUE;
 }
@@ -0,0 +1,126 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "local.h"
+
+/*
+ * Split the services that can be stopped in waves for a shutdown.
+ *
+ * Wave 1 is the services nothing running depends on, and every later
+ * wave holds the services whose dependents are all in earlier waves,
+ * so a whole wave can be stopped at once when the one before is down.
+ * What is still loading has no deps known yet, and goes in the last
+ * wave together with what is left in a circle. Sets stop_wave of
+ * every service, 0 for those not to be stopped, and returns the number
+ * of waves.
+ */
+
+static int stoppable(active_db_h * service)
+{
+	switch (GET_STATE(service)) {
+	case IS_UP:
+	case IS_STARTING:
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
+int initng_depend_stop_waves(void)
+{
+	active_db_h *current = NULL;
+	active_db_h **queue;
+	s_dep *edge;
+	int *left;
+	int len = 0;
+	int head = 0;
+	int end;
+	int waves = 0;
+	int last = 0;
+	int i;
+
+	initng_depend_graph_sync();
+
+	queue = initng_toolbox_calloc(initng_depend_reach_ids() + 1,
+				      sizeof(active_db_h *));
+	left = initng_toolbox_calloc(initng_depend_reach_ids() + 1,
+				     sizeof(int));
+
+	/* count the running dependents of everything to stop */
+	while_active_db(current) {
+		current->stop_wave = 0;
+		if (!stoppable(current))
+			continue;
+
+		while_depend_redges(i, edge, current) {
+			if (DEP_IS_DEPEND(edge) && stoppable(edge->from))
+				left[current->deps_id]++;
+		}
+
+		if (!left[current->deps_id])
+			queue[len++] = current;
+	}
+
+	/* peel them off a wave at a time */
+	while (head < len) {
+		waves++;
+
+		for (end = len; head < end; head++) {
+			current = queue[head];
+			current->stop_wave = waves;
+
+			while_depend_edges(edge, current) {
+				if (!DEP_IS_DEPEND(edge) || !edge->to ||
+				    !stoppable(edge->to))
+					continue;
+
+				if (--left[edge->to->deps_id] == 0)
+					queue[len++] = edge->to;
+			}
+		}
+	}
+
+	free(queue);
+	free(left);
+
+	/* a circle never gets free, stop what is left last */
+	while_active_db(current) {
+		if (current->stop_wave)
+			continue;
+
+		if (GET_STATE(current) == IS_NEW) {
+			D_("Service %s is still loading, stopping it last.\n",
+			   current->name);
+		} else if (stoppable(current)) {
+			W_("Service %s is in a circle, stopping it last.\n",
+			   current->name);
+		} else {
+			continue;
+		}
+
+		current->stop_wave = last = waves + 1;
+	}
+
+	return last ? last : waves;
+}
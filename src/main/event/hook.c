@@ -44,6 +44,7 @@ int initng_event_hook_register_real(const char *from_file, s_event_type * t,
 	new_call->c.pointer = hook;
 
 	initng_list_add(&new_call->list, &t->hooks.list);
+	t->hooks_gen++;
 
 	return TRUE;
 }
@@ -67,6 +68,7 @@ void initng_event_hook_unregister_real(const char *from_file,
 			continue;
 
 		initng_list_del(&current->list);
+		t->hooks_gen++;
 
 		free(current->from_file);
 
@@ -60,6 +60,12 @@ s_event_type EVENT_AFTER_FORK = {
 	.description = "Triggered after a process forks to start"
 };
 
+s_event_type EVENT_SPAWN_PLAN = {
+	.name = "spawn_plan",
+	.description = "Triggered in initng to plan what the child of a "
+	    "process does before execve, again when the service data changes"
+};
+
 s_event_type EVENT_START_DEP_MET = {
 	.name = "start_dep_met",
 	.description = "Triggered when a service is about to start"
@@ -126,8 +132,8 @@ s_event_type EVENT_BUFFER_WATCHER = {
 };
 s_event_type EVENT_IO_WATCHER = {
 	.name = "io_watcher",
-	.description = "Triggered when initng open file descriptors receive "
-	    "data"
+	.description = "Triggered when initng open file descriptors should "
+	    "be closed or listed"
 };
 
 s_event_type EVENT_INTERRUPT = {
@@ -135,6 +141,12 @@ s_event_type EVENT_INTERRUPT = {
 	.description = "When initng gets an sysreq, it will get here"
 };
 
+s_event_type EVENT_STOP_WAVE = {
+	.name = "stop_wave",
+	.description = "Triggered when a shutdown wave is stopped, and when "
+	    "it is done"
+};
+
 s_event_type HALT = {
 	.name = "halt",
 	.description = "Initng got a request to halt"
@@ -154,6 +166,7 @@ void initng_register_static_event_types(void)
 	initng_event_type_register(&EVENT_MAIN);
 	initng_event_type_register(&EVENT_LAUNCH);
 	initng_event_type_register(&EVENT_AFTER_FORK);
+	initng_event_type_register(&EVENT_SPAWN_PLAN);
 	initng_event_type_register(&EVENT_START_DEP_MET);
 	initng_event_type_register(&EVENT_STOP_DEP_MET);
 	initng_event_type_register(&EVENT_PIPE_WATCHER);
@@ -168,6 +181,7 @@ void initng_register_static_event_types(void)
 	initng_event_type_register(&EVENT_BUFFER_WATCHER);
 	initng_event_type_register(&EVENT_IO_WATCHER);
 	initng_event_type_register(&EVENT_INTERRUPT);
+	initng_event_type_register(&EVENT_STOP_WAVE);
 	initng_event_type_register(&HALT);
 	initng_event_type_register(&REBOOT);
 }
@@ -70,6 +70,8 @@ void initng_event_type_register(s_event_type * ent)
 
 	/* add the event to the event_db list */
 	initng_list_add(&ent->list, &g.event_db.list);
+	if (ent->name)
+		initng_symbol_add(SYMBOL_EVENT, ent->name, ent);
 #ifdef DEBUG
 	if (ent->name)
 		D_(" \"%s\" added to option_db!\n", ent->name);
@@ -82,6 +84,20 @@ void initng_event_type_register(s_event_type * ent)
 void initng_event_type_unregister(s_event_type * ent)
 {
 	initng_list_del(&ent->list);
+
+	/* if another event had the same name, it is found from now on */
+	if (ent->name && initng_symbol_del(SYMBOL_EVENT, ent->name, ent)) {
+		s_event_type *current = NULL;
+
+		while_event_types(current) {
+			if (current->name &&
+			    strcmp(current->name, ent->name) == 0) {
+				initng_symbol_add(SYMBOL_EVENT, current->name,
+						  current);
+				break;
+			}
+		}
+	}
 }
 
 /*
@@ -106,14 +122,9 @@ void initng_event_type_unregister_all(void)
  */
 s_event_type *initng_event_type_find(const char *string)
 {
-	s_event_type *current = NULL;
-
 	S_;
 	assert(string);
 	D_("looking for %s.\n", string);
-	while_event_types(current) {
-		if (current->name && strcmp(current->name, string) == 0)
-			return current;
-	}
-	return NULL;
+
+	return initng_symbol_find(SYMBOL_EVENT, string);
 }
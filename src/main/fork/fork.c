@@ -35,7 +35,9 @@
 
 #include <initng.h>
 
-inline static void pipes_create(process_h *process)
+#include "local.h"
+
+void initng_fork_pipes_create(process_h * process)
 {
 	pipe_h *current_pipe = NULL;
 
@@ -60,7 +62,7 @@ inline static void pipes_create(process_h *process)
 /**
  * Walk all pipes and close all remote sides of pipes
  */
-inline static void pipes_close_remote_side(process_h *process)
+void initng_fork_pipes_close_remote(process_h * process)
 {
 	pipe_h *pipe = NULL;
 
@@ -96,7 +98,7 @@ inline static void pipes_close_remote_side(process_h *process)
  * pipe is for sending output FROM the fork, to initng for handle, the input
  * part should be closed here, the other are mapped to STDOUT and STDERR.
  */
-inline static void pipes_setup_local_side(process_h *process)
+void initng_fork_pipes_setup_local(process_h * process)
 {
 	pipe_h *pipe = NULL;
 
@@ -146,7 +148,7 @@ pid_t initng_fork(active_db_h * service, process_h * process)
 	assert(process);
 
 	/* Create all pipes */
-	pipes_create(process);
+	initng_fork_pipes_create(process);
 
 	/* Try to fork 30 times */
 	while ((pid_fork = fork()) == -1) {
@@ -175,7 +177,7 @@ pid_t initng_fork(active_db_h * service, process_h * process)
 		setsid();	/* Run a program in a new
 				 * session ??? */
 
-		pipes_setup_local_side(process);
+		initng_fork_pipes_setup_local(process);
 
 		/* TODO, what does this do? */
 		/* run this in foreground on fd 0 */
@@ -186,11 +188,15 @@ pid_t initng_fork(active_db_h * service, process_h * process)
 		struct timespec nap = { 0, ALL_NANOSLEEP };
 		nanosleep(&nap, NULL);
 	} else {
-		pipes_close_remote_side(process);
+		initng_fork_pipes_close_remote(process);
+
+		/* let the main loop poll our side of the pipes */
+		if (pid_fork > 0)
+			initng_io_process_register(service, process);
 
 		/* set process->pid if lucky */
 		if (pid_fork > 0)
-			process->pid = pid_fork;
+			initng_process_db_set_pid(process, service, pid_fork);
 	}
 
 	return pid_fork;
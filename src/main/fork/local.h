@@ -0,0 +1,80 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __LOCAL_H
+#define __LOCAL_H
+
+/* the pipes of a process, see fork.c */
+void initng_fork_pipes_create(process_h * process);
+void initng_fork_pipes_close_remote(process_h * process);
+void initng_fork_pipes_setup_local(process_h * process);
+
+/* the syscalls a compiled plan makes in the child, in this order */
+typedef enum {
+	SPAWN_OP_OPEN = 0,
+	SPAWN_OP_DUP = 1,
+	SPAWN_OP_LIMIT = 2,
+	SPAWN_OP_NICE = 3,
+	SPAWN_OP_CHROOT = 4,
+	SPAWN_OP_CHDIR = 5,
+	SPAWN_OP_GROUPS = 6,
+	SPAWN_OP_GID = 7,
+	SPAWN_OP_UID = 8,
+} e_spawn_op;
+
+typedef struct {
+	e_spawn_op op;
+	int fd;				/* OPEN, DUP onto, LIMIT resource */
+	union {
+		int flags;		/* OPEN */
+		int from;		/* DUP */
+		int inc;		/* NICE */
+		int len;		/* GROUPS */
+		gid_t gid;		/* GID */
+		uid_t uid;		/* UID */
+	} n;
+	union {
+		const char *path;	/* OPEN, CHROOT, CHDIR */
+		const struct rlimit *rlim;	/* LIMIT */
+		const gid_t *groups;	/* GROUPS */
+	} p;
+} s_spawn_op;
+
+/*
+ * A compiled s_spawn, one block with what the ops point at after them,
+ * kept in the service per process type, see plan.c
+ */
+typedef struct s_spawn_plan {
+	struct s_spawn_plan *next;
+	ptype_h *pt;
+	unsigned int data_gen;		/* service->data_gen it was made at */
+	unsigned int hooks_gen;		/* EVENT_SPAWN_PLAN.hooks_gen */
+	int kept;			/* in the service, else free it */
+	int fork;
+	int env_len;
+	const char **env;		/* NAME=value, see s_spawn */
+	int ops_len;
+	s_spawn_op ops[];
+} s_spawn_plan;
+
+s_spawn_plan *initng_spawn_plan_get(active_db_h * service,
+				    process_h * process);
+void initng_spawn_plan_put(s_spawn_plan * plan);
+
+#endif
@@ -0,0 +1,323 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <sys/types.h>
+#include <sys/resource.h>
+
+#include <initng.h>
+
+#include "local.h"
+
+/*
+ * Launch plans.
+ *
+ * What the modules put in an s_spawn is compiled to a list of syscalls,
+ * with all they need copied after it in the same block, so the child
+ * of initng_spawn() only walks it. It is made the first time a process
+ * type of a service is launched, and kept in the service until its
+ * data changes, or a module hooking EVENT_SPAWN_PLAN comes or goes.
+ */
+
+int initng_spawn_add_open(s_spawn * plan, const char *path, int flags,
+			  int to)
+{
+	assert(plan);
+	assert(path);
+
+	if (plan->fds_len >= SPAWN_FDS) {
+		F_("Too many fds to set up in the child.\n");
+		return FALSE;
+	}
+
+	plan->fds[plan->fds_len].path = path;
+	plan->fds[plan->fds_len].flags = flags;
+	plan->fds[plan->fds_len].to = to;
+	plan->fds_len++;
+	return TRUE;
+}
+
+int initng_spawn_add_fd(s_spawn * plan, int from, int to)
+{
+	assert(plan);
+
+	if (plan->fds_len >= SPAWN_FDS) {
+		F_("Too many fds to set up in the child.\n");
+		return FALSE;
+	}
+
+	plan->fds[plan->fds_len].path = NULL;
+	plan->fds[plan->fds_len].from = from;
+	plan->fds[plan->fds_len].to = to;
+	plan->fds_len++;
+	return TRUE;
+}
+
+int initng_spawn_add_limit(s_spawn * plan, int resource,
+			   const struct rlimit *rlim)
+{
+	assert(plan);
+	assert(rlim);
+
+	if (plan->limits_len >= SPAWN_LIMITS) {
+		F_("Too many limits to set in the child.\n");
+		return FALSE;
+	}
+
+	plan->limits[plan->limits_len].resource = resource;
+	plan->limits[plan->limits_len].rlim = *rlim;
+	plan->limits_len++;
+	return TRUE;
+}
+
+int initng_spawn_add_env(s_spawn * plan, const char *name,
+			 const char *value)
+{
+	assert(plan);
+	assert(name);
+	assert(value);
+
+	if (plan->env_len >= SPAWN_ENV) {
+		F_("Too many env variables to set in the child.\n");
+		return FALSE;
+	}
+
+	plan->env[plan->env_len].name = name;
+	plan->env[plan->env_len].value = value;
+	plan->env_len++;
+	return TRUE;
+}
+
+/* copy a string to the end of the block */
+static const char *put_string(char **end, const char *s)
+{
+	char *copy = *end;
+	size_t len = strlen(s) + 1;
+
+	memcpy(copy, s, len);
+	*end += len;
+	return copy;
+}
+
+static s_spawn_plan *compile(const s_spawn * spec)
+{
+	s_spawn_plan *plan;
+	s_spawn_op *op;
+	struct rlimit *rlim;
+	gid_t *groups;
+	char *strings;
+	size_t size;
+	int ops, i;
+
+	/* count what goes in the block */
+	ops = spec->fds_len + spec->limits_len + (spec->set_nice != 0) +
+	    (spec->chroot != NULL) + (spec->chdir != NULL) +
+	    (spec->groups_len >= 0) + (spec->gid != 0) + (spec->uid != 0);
+
+	size = sizeof(s_spawn_plan) + ops * sizeof(s_spawn_op) +
+	    spec->env_len * sizeof(char *) +
+	    spec->limits_len * sizeof(struct rlimit);
+	if (spec->groups_len > 0)
+		size += spec->groups_len * sizeof(gid_t);
+	for (i = 0; i < spec->fds_len; i++) {
+		if (spec->fds[i].path)
+			size += strlen(spec->fds[i].path) + 1;
+	}
+	if (spec->chroot)
+		size += strlen(spec->chroot) + 1;
+	if (spec->chdir)
+		size += strlen(spec->chdir) + 1;
+	for (i = 0; i < spec->env_len; i++) {
+		size += strlen(spec->env[i].name) + 1 +
+		    strlen(spec->env[i].value) + 1;
+	}
+
+	plan = initng_toolbox_calloc(1, size);
+	plan->fork = spec->fork;
+	plan->ops_len = ops;
+	plan->env_len = spec->env_len;
+
+	/* ops first, then the env, limits, groups and strings they point
+	 * at */
+	op = plan->ops;
+	plan->env = (const char **)(plan->ops + ops);
+	rlim = (struct rlimit *)(plan->env + spec->env_len);
+	groups = (gid_t *) (rlim + spec->limits_len);
+	strings = (char *)(groups +
+			   (spec->groups_len > 0 ? spec->groups_len : 0));
+
+	for (i = 0; i < spec->fds_len; i++, op++) {
+		op->fd = spec->fds[i].to;
+		if (spec->fds[i].path) {
+			op->op = SPAWN_OP_OPEN;
+			op->n.flags = spec->fds[i].flags;
+			op->p.path = put_string(&strings, spec->fds[i].path);
+		} else {
+			op->op = SPAWN_OP_DUP;
+			op->n.from = spec->fds[i].from;
+		}
+	}
+
+	for (i = 0; i < spec->limits_len; i++, op++) {
+		op->op = SPAWN_OP_LIMIT;
+		op->fd = spec->limits[i].resource;
+		rlim[i] = spec->limits[i].rlim;
+		op->p.rlim = &rlim[i];
+	}
+
+	if (spec->set_nice) {
+		op->op = SPAWN_OP_NICE;
+		op->n.inc = spec->nice;
+		op++;
+	}
+
+	if (spec->chroot) {
+		op->op = SPAWN_OP_CHROOT;
+		op->p.path = put_string(&strings, spec->chroot);
+		op++;
+	}
+
+	if (spec->chdir) {
+		op->op = SPAWN_OP_CHDIR;
+		op->p.path = put_string(&strings, spec->chdir);
+		op++;
+	}
+
+	if (spec->groups_len >= 0) {
+		op->op = SPAWN_OP_GROUPS;
+		op->n.len = spec->groups_len;
+		memcpy(groups, spec->groups, spec->groups_len * sizeof(gid_t));
+		op->p.groups = groups;
+		op++;
+	}
+
+	if (spec->gid) {
+		op->op = SPAWN_OP_GID;
+		op->n.gid = spec->gid;
+		op++;
+	}
+
+	if (spec->uid) {
+		op->op = SPAWN_OP_UID;
+		op->n.uid = spec->uid;
+		op++;
+	}
+
+	for (i = 0; i < spec->env_len; i++) {
+		char *var = strings;
+
+		strings += strlen(spec->env[i].name);
+		memcpy(var, spec->env[i].name, strings - var);
+		*strings++ = '=';
+		put_string(&strings, spec->env[i].value);
+		plan->env[i] = var;
+	}
+
+	assert(op == plan->ops + ops);
+	return plan;
+}
+
+/* ask the modules, and compile what they say */
+static s_spawn_plan *make(active_db_h * service, process_h * process)
+{
+	s_event event;
+	s_event_spawn_plan_data data;
+	s_spawn spec;
+	s_spawn_plan *plan;
+
+	memset(&spec, 0, sizeof(s_spawn));
+	spec.groups_len = -1;
+
+	event.event_type = &EVENT_SPAWN_PLAN;
+	event.data = &data;
+	data.service = service;
+	data.process = process;
+	data.plan = &spec;
+
+	initng_event_send(&event);
+	if (event.status == FAILED) {
+		F_("Some module did fail to plan the launch of %s.\n",
+		   service->name);
+		return NULL;
+	}
+
+	plan = compile(&spec);
+	plan->pt = process->pt;
+
+	/* modules may set data while planning, that is in it already */
+	plan->data_gen = service->data_gen;
+	plan->hooks_gen = EVENT_SPAWN_PLAN.hooks_gen;
+
+	if (!spec.nocache) {
+		plan->kept = TRUE;
+		plan->next = service->spawn_plans;
+		service->spawn_plans = plan;
+	}
+
+	return plan;
+}
+
+/*
+ * The plan to launch process of service with, or NULL if a module
+ * failed it. Give it back with initng_spawn_plan_put().
+ */
+s_spawn_plan *initng_spawn_plan_get(active_db_h * service,
+				    process_h * process)
+{
+	s_spawn_plan **p, *plan;
+
+	assert(service);
+	assert(process);
+
+	for (p = &service->spawn_plans; (plan = *p); p = &plan->next) {
+		if (plan->pt != process->pt)
+			continue;
+
+		if (plan->data_gen == service->data_gen &&
+		    plan->hooks_gen == EVENT_SPAWN_PLAN.hooks_gen)
+			return plan;
+
+		/* out of date, make it again */
+		*p = plan->next;
+		free(plan);
+		break;
+	}
+
+	return make(service, process);
+}
+
+void initng_spawn_plan_put(s_spawn_plan * plan)
+{
+	if (!plan->kept)
+		free(plan);
+}
+
+void initng_spawn_plans_free(active_db_h * service)
+{
+	s_spawn_plan *plan;
+
+	assert(service);
+
+	while ((plan = service->spawn_plans)) {
+		service->spawn_plans = plan->next;
+		free(plan);
+	}
+}
@@ -0,0 +1,357 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#define _DEFAULT_SOURCE		/* setgroups() */
+
+#include <unistd.h>		/* vfork() execve() nice() chroot() */
+#include <signal.h>
+#include <stdio.h>		/* snprintf() */
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>		/* nanosleep() */
+#include <errno.h>
+#include <assert.h>
+#include <fcntl.h>		/* open() */
+#include <grp.h>		/* setgroups() */
+#include <sys/types.h>
+#include <sys/ioctl.h>		/* ioctl() */
+#include <sys/resource.h>	/* setrlimit() */
+
+#include <initng.h>
+
+#include "local.h"
+
+/*
+ * The spawn launcher.
+ *
+ * Forking initng copies the page tables of all of it, and the child
+ * then runs every EVENT_AFTER_FORK hook before execve. Instead, what
+ * the child has to do is planned by modules with EVENT_SPAWN_PLAN, in
+ * initng, and compiled once per service, see plan.c. The child is
+ * started with vfork(), shares the memory of initng, and only makes
+ * the syscalls of the plan before execve, while initng waits for it.
+ * A module that has to run code in the child sets fork in the plan,
+ * and then the child is forked, and EVENT_AFTER_FORK sent in it, as
+ * with initng_fork().
+ */
+
+/* a vforked child tells what failed here */
+static const char *volatile failed_what;
+static volatile int failed_errno;
+
+/* and a file it went on without */
+static const s_spawn_op *volatile unopened_op;
+static volatile int unopened_errno;
+
+extern const char *initng_environ[];
+
+/* the syscall of each e_spawn_op */
+static const char *const op_names[] = {
+	"open", "dup2", "setrlimit", "nice", "chroot", "chdir", "setgroups",
+	"setgid", "setuid"
+};
+
+/*
+ * Make the syscalls of the plan, in the child. Nothing else here, it
+ * runs in a vforked child. Returns the op that failed, or NULL.
+ */
+static const s_spawn_op *run(const s_spawn_plan * plan)
+{
+	const s_spawn_op *op;
+	int i, fd;
+
+	for (i = 0; i < plan->ops_len; i++) {
+		op = &plan->ops[i];
+
+		switch (op->op) {
+		case SPAWN_OP_OPEN:
+			/* the output is left to initng then, as before */
+			if ((fd = open(op->p.path, op->n.flags, 0644)) < 0) {
+				unopened_errno = errno;
+				unopened_op = op;
+				break;
+			}
+			if (fd != op->fd) {
+				if (dup2(fd, op->fd) < 0)
+					return op;
+				close(fd);
+			}
+			break;
+		case SPAWN_OP_DUP:
+			if (dup2(op->n.from, op->fd) < 0)
+				return op;
+			break;
+		case SPAWN_OP_LIMIT:
+			if (setrlimit(op->fd, op->p.rlim) != 0)
+				return op;
+			break;
+		case SPAWN_OP_NICE:
+			errno = 0;
+			if (nice(op->n.inc) == -1 && errno != 0)
+				return op;
+			break;
+		case SPAWN_OP_CHROOT:
+			if (chdir(op->p.path) != 0 || chroot(op->p.path) != 0)
+				return op;
+			break;
+		case SPAWN_OP_CHDIR:
+			if (chdir(op->p.path) != 0)
+				return op;
+			break;
+		case SPAWN_OP_GROUPS:
+			if (setgroups(op->n.len, op->p.groups) != 0)
+				return op;
+			break;
+		case SPAWN_OP_GID:
+			if (setgid(op->n.gid) != 0)
+				return op;
+			break;
+		case SPAWN_OP_UID:
+			if (setuid(op->n.uid) != 0)
+				return op;
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+/* is env[i] one of initng_environ, those strings are not ours */
+static int is_default(char **env, int i)
+{
+	int n;
+
+	for (n = 0; n <= i; n++) {
+		if (!initng_environ[n])
+			return FALSE;
+	}
+
+	return env[i] == initng_environ[i];
+}
+
+/*
+ * Add the env of the plan to env. It goes over the defaults of
+ * initng_environ, but what the service sets itself is kept.
+ */
+static char **env_plan(char **env, const s_spawn_plan * plan)
+{
+	int nr, i, j;
+
+	if (!plan->env_len)
+		return env;
+
+	for (nr = 0; env[nr]; nr++) ;
+	env = realloc(env, (nr + plan->env_len + 1) * sizeof(char *));
+
+	for (i = 0; i < plan->env_len; i++) {
+		size_t len = strchr(plan->env[i], '=') - plan->env[i] + 1;
+
+		for (j = 0; j < nr; j++) {
+			if (strncmp(env[j], plan->env[i], len) == 0)
+				break;
+		}
+
+		if (j == nr)
+			nr++;
+		else if (!is_default(env, j))
+			continue;
+
+		env[j] = initng_toolbox_strdup(plan->env[i]);
+	}
+
+	env[nr] = NULL;
+	return env;
+}
+
+/*
+ * initng_env_new() is meant to be called in the child, here it is made
+ * in initng, so INITNG_PID is our pid, not our parent's.
+ */
+static char **env_new(active_db_h * service, const s_spawn_plan * plan)
+{
+	char **env = initng_env_new(service);
+	int i;
+
+	for (i = 0; env[i]; i++) {
+		if (strncmp(env[i], "INITNG_PID=", 11) == 0) {
+			snprintf(env[i], 32, "INITNG_PID=%d", (int)getpid());
+			break;
+		}
+	}
+
+	return env_plan(env, plan);
+}
+
+static void env_free(char **env)
+{
+	int i;
+
+	for (i = 0; env[i]; i++) {
+		if (!is_default(env, i))
+			free(env[i]);
+	}
+
+	free(env);
+}
+
+/* the vforked child, never returns */
+static void child(process_h * process, const s_spawn_plan * plan,
+		  char **argv, char **env)
+{
+	struct sigaction sa;
+	sigset_t none;
+	const s_spawn_op *op;
+	int i;
+
+	/* no initng handlers in here */
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = SIG_DFL;
+	sigemptyset(&sa.sa_mask);
+	for (i = 1; i < NSIG; i++) {
+		struct sigaction old;
+
+		if (sigaction(i, NULL, &old) == 0 &&
+		    old.sa_handler != SIG_DFL && old.sa_handler != SIG_IGN)
+			sigaction(i, &sa, NULL);
+	}
+
+	sigemptyset(&none);
+	sigprocmask(SIG_SETMASK, &none, NULL);
+
+#ifndef __HAIKU__
+	ioctl(0, TIOCNOTTY, 0);
+#endif
+	setsid();
+
+	initng_fork_pipes_setup_local(process);
+	tcsetpgrp(0, getpgrp());
+
+	if ((op = run(plan))) {
+		failed_errno = errno;
+		failed_what = op_names[op->op];
+	} else {
+		execve(argv[0], argv, env);
+		failed_errno = errno;
+		failed_what = "execve";
+	}
+
+	_exit(1);
+}
+
+/*
+ * Launch argv[0] as process of service. Returns the pid of the child,
+ * or -1.
+ */
+pid_t initng_spawn(active_db_h * service, process_h * process, char **argv)
+{
+	s_spawn_plan *plan;
+	const s_spawn_op *op;
+	sigset_t all, old;
+	char **env;
+	pid_t pid;
+	int try_count = 0;
+	int e;
+
+	assert(service);
+	assert(process);
+	assert(argv && argv[0]);
+
+	if (!(plan = initng_spawn_plan_get(service, process)))
+		return -1;
+
+	unopened_op = NULL;
+	unopened_errno = 0;
+
+	/* some module needs to run in the child */
+	if (plan->fork) {
+		pid = initng_fork(service, process);
+		if (pid == 0) {
+			initng_fork_aforkhooks(service, process);
+
+			op = run(plan);
+			if (unopened_op)
+				F_("Can't open %s for %s: %s\n",
+				   unopened_op->p.path, service->name,
+				   strerror(unopened_errno));
+			if (!op) {
+				execve(argv[0], argv,
+				       env_plan(initng_env_new(service),
+						plan));
+				F_("Can't launch %s, execve failed: %s\n",
+				   argv[0], strerror(errno));
+			} else {
+				F_("Can't launch %s, %s failed: %s\n", argv[0],
+				   op_names[op->op], strerror(errno));
+			}
+			_exit(1);
+		}
+
+		initng_spawn_plan_put(plan);
+		return pid;
+	}
+
+	env = env_new(service, plan);
+	initng_fork_pipes_create(process);
+
+	/* no handler may run in the child, it shares our memory */
+	sigfillset(&all);
+	sigprocmask(SIG_SETMASK, &all, &old);
+
+	failed_what = NULL;
+	failed_errno = 0;
+
+	/* try 30 times, as initng_fork() */
+	while ((pid = vfork()) == -1 && try_count < 30) {
+		struct timespec nap = { 0, 2000 * ++try_count };
+
+		F_("Failed to vfork, try no# %i: %s\n", try_count,
+		   strerror(errno));
+		nanosleep(&nap, NULL);
+	}
+
+	if (pid == 0)
+		child(process, plan, argv, env);
+	e = errno;
+
+	sigprocmask(SIG_SETMASK, &old, NULL);
+
+	env_free(env);
+	initng_fork_pipes_close_remote(process);
+
+	if (pid < 0) {
+		F_("Failed to vfork: %s\n", strerror(e));
+		initng_spawn_plan_put(plan);
+		return -1;
+	}
+
+	if (unopened_op)
+		F_("Can't open %s for %s: %s\n", unopened_op->p.path,
+		   service->name, strerror(unopened_errno));
+	initng_spawn_plan_put(plan);
+
+	/* it exits, and is handled as any process that does */
+	if (failed_what)
+		F_("Can't launch %s, %s failed: %s\n", argv[0], failed_what,
+		   strerror(failed_errno));
+
+	initng_io_process_register(service, process);
+	initng_process_db_set_pid(process, service, pid);
+
+	return pid;
+}
@@ -44,7 +44,7 @@
 #include <initng.h>
 #include <initng-paths.h>
 #include "options.h"
-#define TIMEOUT 60000
+#define TIMEOUT 60000	/* ms */
 
 int main(int argc, char *argv[], char *env[])
 {
@@ -153,13 +153,8 @@ int main(int argc, char *argv[], char *env[])
 		/* if a sleep is set */
 		g.sleep_seconds = 0;
 
-		/* run state alarm if timeout */
-		/*
-		 * Run all alarm state callers.
-		 * If there is more later alarms, this will set new ones.
-		 */
-		if (g.next_alarm && g.next_alarm <= g.now.tv_sec)
-			initng_handler_run_alarm();
+		/* run all state alarms and timers that are due */
+		initng_timer_run();
 
 		/* handle signals */
 		initng_signal_dispatch();
@@ -212,29 +207,26 @@ int main(int argc, char *argv[], char *env[])
 		{
 			/* set it to default */
 			int closest_timeout = TIMEOUT;
+			int time_to_next = initng_timer_next();
 
 			/* if sleepseconds are set */
 			if (g.sleep_seconds &&
-			    g.sleep_seconds < closest_timeout)
-				closest_timeout = g.sleep_seconds;
-
-			/* Check how many seconds there are to the state
-			 * alarm */
-			if (g.next_alarm && g.next_alarm > g.now.tv_sec) {
-				int time_to_next = g.next_alarm - g.now.tv_sec;
+			    g.sleep_seconds * 1000 < closest_timeout)
+				closest_timeout = g.sleep_seconds * 1000;
 
-				D_("g.next_alarm is set!, will trigger in %i "
-				   "sec.\n", time_to_next);
+			/* Check how many ms there are to the next timer */
+			if (time_to_next >= 0) {
+				D_("A timer is set!, will trigger in %i ms.\n",
+				   time_to_next);
 				if (time_to_next < closest_timeout)
 					closest_timeout = time_to_next;
 			}
 
-			/* if we got some seconds */
+			/* if we got some time */
 			if (closest_timeout > 0 && interrupt == FALSE) {
 				/* do a poll == the same as sleep but also
 				 * watch fds */
-				D_("Will sleep for %i seconds.\n",
-				   closest_timeout);
+				D_("Will sleep for %i ms.\n", closest_timeout);
 				initng_io_module_poll(closest_timeout);
 			}
 		}
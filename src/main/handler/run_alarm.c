@@ -31,42 +31,20 @@
 #include <errno.h>
 
 /*
- * Find alarm, will brows active_db for states when the timeout have gone
- * out and run them.
+ * The callback of active_db_h->alarm, runs the alarm handler of the
+ * state the service is in when the timer goes off.
  */
-void initng_handler_run_alarm(void)
+void initng_handler_run_alarm(s_timer * alarm)
 {
-	active_db_h *current, *q = NULL;
+	active_db_h *service = initng_list_entry(alarm, active_db_h, alarm);
 
-	S_;
+	assert(service->name);
+	assert(service->current_state);
 
-	/* reset next_alarm */
-	g.next_alarm = 0;
+	D_("Alarm for %s in state %s\n", service->name,
+	   service->current_state->name);
 
-	/* walk through all active services */
-	while_active_db_safe(current, q) {
-		assert(current->name);
-		assert(current->current_state);
-
-		/* skip services where alarm is not set */
-		if (current->alarm == 0)
-			continue;
-
-		/* if alarm has gone */
-		if (g.now.tv_sec >= current->alarm) {
-			/* reset alarm */
-			current->alarm = 0;
-
-			/* call alarm handler, now when we got an g.interrupt */
-			if (current->current_state->alarm)
-				(*current->current_state->alarm) (current);
-
-			continue;
-		}
-
-		/* if this alarm is more early than next_to_get, or
-		   next_to_get isn't set. */
-		if (current->alarm < g.next_alarm || !g.next_alarm)
-			g.next_alarm = current->alarm;
-	}
+	/* call alarm handler */
+	if (service->current_state->alarm)
+		(*service->current_state->alarm) (service);
 }
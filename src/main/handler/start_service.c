@@ -77,10 +77,11 @@ int initng_handler_start_service(active_db_h * service_to_start)
 		return TRUE;
 
 	/* if new, and not got a stopped state yet, its no idea to bug this
-	 * process */
+	 * process, it is started when it gets one */
 	case IS_NEW:
-		D_("service %s is so fresh so we cant start it.\n",
+		D_("service %s is so fresh so we cant start it yet.\n",
 		   service_to_start->name);
+		service_to_start->start_wanted = TRUE;
 		return TRUE;
 
 	/* it must be down or stopping to start it */
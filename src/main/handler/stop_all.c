@@ -29,26 +29,171 @@
 #include <stdlib.h>		/* free() exit() */
 #include <assert.h>
 #include <errno.h>
+#include <signal.h>		/* kill() */
 
-/* enter a new runlevel */
-int initng_handler_stop_all(void)
+/*
+ * The shutdown is planned in waves, see initng_depend_stop_waves().
+ * A whole wave is stopped at once, and the next one when every service
+ * in it is down. A wave that is not down in WAVE_TIMEOUT has the
+ * processes left killed, so one hanging service can't hold up the
+ * rest of the shutdown. Services set never_kill are only asked again.
+ */
+#define WAVE_TIMEOUT 45		/* seconds */
+
+static s_timer wave_timer;
+static int wave = 0;
+static int waves = 0;
+static int services;		/* in the current wave */
+static int left;		/* of them not down yet */
+static uint64_t began;
+
+static int is_stopped(active_db_h * service)
+{
+	switch (GET_STATE(service)) {
+	case IS_DOWN:
+	case IS_FAILED:
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
+static void report(void)
 {
-	active_db_h *ser, *q = NULL;
+	s_event event;
+	s_event_stop_wave_data data;
 
-	S_;
-	initng_main_set_sys_state(STATE_STOPPING);
+	data.wave = wave;
+	data.waves = waves;
+	data.services = services;
+	data.left = left;
+
+	event.event_type = &EVENT_STOP_WAVE;
+	event.data = &data;
+
+	initng_event_send(&event);
+}
+
+/* stop the next wave that has anything to wait for */
+static void next_wave(void)
+{
+	active_db_h *current, *safe = NULL;
+
+	initng_timer_cancel(&wave_timer);
+
+	while (wave < waves) {
+		wave++;
+		services = 0;
+		left = 0;
+		began = initng_timer_now();
+
+		while_active_db_safe(current, safe) {
+			if (current->stop_wave != wave)
+				continue;
+
+			services++;
+
+			/* still loading, it is down as soon as it is loaded */
+			if (GET_STATE(current) == IS_NEW) {
+				current->start_wanted = FALSE;
+				left++;
+				continue;
+			}
+
+			if (initng_handler_stop_service(current) == TRUE &&
+			    !is_stopped(current))
+				left++;
+			else
+				current->stop_wave = 0;
+		}
+
+		D_("Stop wave %i of %i, %i services.\n", wave, waves,
+		   services);
+		report();
+
+		if (left) {
+			initng_timer_arm(&wave_timer, WAVE_TIMEOUT * 1000);
+			return;
+		}
+	}
 
-	while_active_db_safe(ser, q) {
-		/* don't stop a stopping service */
-		switch (GET_STATE(ser)) {
-		case IS_STOPPING:
-		case IS_DOWN:
-		case IS_FAILED:
+	/* all done */
+	waves = 0;
+}
+
+static void wave_timeout(s_timer * timer)
+{
+	active_db_h *current, *safe = NULL;
+	process_h *process = NULL;
+	s_entry *never_kill = initng_service_data_type_find("never_kill");
+	int killed;
+
+	(void)timer;
+
+	W_("Stop wave %i of %i timed out, killing the %i services left.\n",
+	   wave, waves, left);
+
+	while_active_db_safe(current, safe) {
+		if (current->stop_wave != wave)
+			continue;
+
+		current->stop_wave = 0;
+		if (GET_STATE(current) == IS_NEW)
 			continue;
+
+		killed = FALSE;
+		if (!never_kill || !is(never_kill, current)) {
+			while_processes(process, current) {
+				if (process->pid > 0 &&
+				    kill(process->pid, SIGKILL) == 0)
+					killed = TRUE;
+			}
 		}
 
-		/* stop services */
-		initng_handler_stop_service(ser);
+		/* ask again, for what got started meanwhile or is not killed */
+		if (!killed)
+			initng_handler_stop_service(current);
 	}
+
+	next_wave();
+}
+
+/*
+ * Called for every service that changed state, counts down the
+ * current wave.
+ */
+void initng_handler_stop_wave_changed(active_db_h * service)
+{
+	assert(service);
+
+	if (!waves || service->stop_wave != wave || !is_stopped(service))
+		return;
+
+	service->stop_wave = 0;
+	if (--left > 0)
+		return;
+
+	P_("Stop wave %i of %i done, %i services in %i ms.\n", wave, waves,
+	   services, (int)(initng_timer_now() - began));
+	report();
+	next_wave();
+}
+
+/* enter a new runlevel */
+int initng_handler_stop_all(void)
+{
+	S_;
+	initng_main_set_sys_state(STATE_STOPPING);
+
+	/* plan over again, if already stopping */
+	if (waves)
+		initng_timer_cancel(&wave_timer);
+	initng_timer_init(&wave_timer, &wave_timeout);
+
+	wave = 0;
+	waves = initng_depend_stop_waves();
+	D_("Stopping in %i waves.\n", waves);
+
+	next_wave();
 	return TRUE;
 }
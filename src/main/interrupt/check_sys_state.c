@@ -33,18 +33,14 @@
 
 void check_sys_state_up(void)
 {
-	active_db_h *current = NULL;
-
 	/* If system is not starting, we have nothing to set. */
 	if (g.sys_state != STATE_STARTING)
 		return;
 
-	/* check actives, if any has one of these status, system cant be set
-	 * to STATE_UP */
-	while_active_db(current) {
-		if (GET_STATE(current) == IS_STARTING)
-			return;
-	}
+	/* if any service is still starting, system cant be set to
+	 * STATE_UP */
+	if (g.active_db_is[IS_STARTING] > 0)
+		return;
 
 	/* OK, system is up */
 	initng_main_set_sys_state(STATE_UP);
@@ -46,13 +46,35 @@ int initng_interrupt(void)
 		/* remove from interrupt list */
 		initng_list_del(&service->interrupt);
 
+		/* drop its start dep counts, and count down the services
+		 * waiting for it to come up */
+		initng_depend_unschedule(service);
+		initng_depend_state_changed(service);
+
+		/* it may finish a shutdown wave */
+		initng_handler_stop_wave_changed(service);
+
+		/* wake it, and the services waiting for it */
+		initng_interrupt_wake(service);
+
 		/* handle this one. */
 		handle(service);
+
+		/* it was asked to start while it was new */
+		if (service->start_wanted && GET_STATE(service) != IS_NEW) {
+			service->start_wanted = FALSE;
+			if (GET_STATE(service) == IS_DOWN)
+				initng_handler_start_service(service);
+		}
 	}
 
-	/* if there was any interupt, run interupt handler hooks */
+	/* if there was any interupt, wake the module watchers */
 	if (interrupt)
-		run_interrupt_handlers();
+		initng_interrupt_wake_watchers();
+
+	/* run the handlers of the woken and ready services */
+	if (run_interrupt_handlers())
+		interrupt = TRUE;
 
 	/* return positive if any interupt was handled */
 	return interrupt;
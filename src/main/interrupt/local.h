@@ -20,11 +20,18 @@
 #ifndef __LOCAL_H
 #define __LOCAL_H
 
+/* number of buckets waiting services are hashed into, by wait_for */
+#define WAIT_BUCKETS 64
+
 void check_sys_state_up(void);
 void dep_failed_to_start(active_db_h * service);
 void dep_failed_to_stop(active_db_h * service);
-void run_interrupt_handlers(void);
+int run_interrupt_handlers(void);
 
 void handle(active_db_h * service);
 
+void initng_interrupt_wake(active_db_h * service);
+void initng_interrupt_wake_watchers(void);
+active_db_h *initng_interrupt_next_woken(void);
+
 #endif
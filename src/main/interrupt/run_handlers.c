@@ -32,22 +32,26 @@
 #include "local.h"
 
 /*
- * This function is run from main when g.interrupt is set.
- * Will do special actions, for some status mode.
+ * This function is run from main on every loop, and drains the queue of
+ * woken and ready services. Returns TRUE if any handler was run.
  */
-void run_interrupt_handlers(void)
+int run_interrupt_handlers(void)
 {
-	active_db_h *current, *q = NULL;
+	active_db_h *current;
+	int ran = FALSE;
 
 	S_;
 
-	/* walk through all active services */
-	while_active_db_safe(current, q) {
+	/* walk through the services woken by this interrupt */
+	while ((current = initng_interrupt_next_woken())) {
 		assert(current->name);
 		assert(current->current_state);
+		ran = TRUE;
 
 		/* call state handler, now when we got an g.interrupt */
 		if (current->current_state->interrupt)
 			(*current->current_state->interrupt) (current);
 	}
+
+	return ran;
 }
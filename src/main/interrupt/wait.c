@@ -0,0 +1,154 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+
+#include <assert.h>
+
+#include "local.h"
+
+/*
+ * Services blocked in stop_dep_met park here until the service they
+ * wait for changes state, so an interrupt only wakes the services it
+ * can actually unblock. start_dep_met does not wait here, it counts
+ * the deps not met in deps_unmet and is readied with
+ * initng_interrupt_ready() when that gets to 0. Services blocked by a
+ * module check (EVENT_START_DEP_MET / EVENT_STOP_DEP_MET) can wait for
+ * anything, and are put on the watchers list that is woken on every
+ * interrupt, unless the module holds them until it readies them.
+ */
+static list_t waiters[WAIT_BUCKETS];
+static list_t watchers = LIST_HEAD_INIT(watchers);
+static list_t held = LIST_HEAD_INIT(held);
+static list_t woken = LIST_HEAD_INIT(woken);
+
+static list_t *bucket(hash_t hash)
+{
+	list_t *head = &waiters[hash % WAIT_BUCKETS];
+
+	/* buckets are set up the first time they are used */
+	if (!head->next)
+		initng_list_init(head);
+
+	return head;
+}
+
+/*
+ * Queue service on woken, in the order woken. Which start goes first
+ * when starts are limited is up to the module limiting them, from
+ * start_rank.
+ */
+static void queue(active_db_h * service)
+{
+	list_move_tail(&service->wait, &woken);
+}
+
+/*
+ * Park service until the service named name changes state.
+ */
+void initng_interrupt_wait_for(active_db_h * service, const char *name)
+{
+	assert(service);
+	assert(name);
+
+	service->wait_for = initng_hash_str(name);
+	list_move_tail(&service->wait, bucket(service->wait_for));
+}
+
+/*
+ * Park service until any service changes state.
+ */
+void initng_interrupt_wait_all(active_db_h * service)
+{
+	assert(service);
+
+	service->wait_for = 0;
+	list_move_tail(&service->wait, &watchers);
+}
+
+/*
+ * Park service until the module holding it readies it again with
+ * initng_interrupt_ready().
+ */
+void initng_interrupt_hold(active_db_h * service)
+{
+	assert(service);
+
+	service->wait_for = 0;
+	list_move_tail(&service->wait, &held);
+}
+
+/*
+ * Drop service from any wait or wake list.
+ */
+void initng_interrupt_unwait(active_db_h * service)
+{
+	assert(service);
+
+	initng_list_del(&service->wait);
+}
+
+/*
+ * Service has changed state, wake it and everything waiting for it.
+ */
+void initng_interrupt_wake(active_db_h * service)
+{
+	active_db_h *current, *safe = NULL;
+
+	initng_list_foreach_safe(current, safe, bucket(service->name_hash),
+				 wait) {
+		if (current->wait_for == service->name_hash)
+			queue(current);
+	}
+
+	queue(service);
+}
+
+/*
+ * Queue service for its state interrupt handler, without waiting for it
+ * to change state.
+ */
+void initng_interrupt_ready(active_db_h * service)
+{
+	assert(service);
+
+	queue(service);
+}
+
+void initng_interrupt_wake_watchers(void)
+{
+	while (!initng_list_isempty(&watchers))
+		queue(initng_list_entry(watchers.next, active_db_h,
+					 wait));
+}
+
+/*
+ * Pop the next woken service, NULL when there are no more.
+ */
+active_db_h *initng_interrupt_next_woken(void)
+{
+	active_db_h *service;
+
+	if (initng_list_isempty(&woken))
+		return NULL;
+
+	service = initng_list_entry(woken.next, active_db_h, wait);
+	initng_list_del(&service->wait);
+	return service;
+}
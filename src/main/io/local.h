@@ -20,8 +20,20 @@
 #ifndef __LOCAL_H
 #define __LOCAL_H
 
+#include <sys/epoll.h>
+
 void initng_io_module_readpipe(active_db_h * service, process_h * process,
                                pipe_h * pi, char *buffer_pos);
 int initng_io_pipe(active_db_h * service, process_h * process, pipe_h * pi);
 
+/* max number of ready fds handled on every poll */
+#define IO_MAX_EVENTS 32
+
+/* the epoll instance, and the ready list currently dispatched */
+extern int initng_io_epoll_fd;
+extern struct epoll_event initng_io_ready[IO_MAX_EVENTS];
+extern int initng_io_ready_count;
+
+int initng_io_epoll_open(void);
+
 #endif
@@ -20,13 +20,12 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdarg.h>
-#include <dlfcn.h>
 #include <assert.h>
 #include <errno.h>
 #include <string.h>
-#include <fcntl.h>		/* fcntl() */
+#include <time.h>
 
-#include <sys/select.h>
+#include <sys/epoll.h>
 
 #include <initng.h>
 #include "local.h"
@@ -34,138 +33,34 @@
 /*
  * FILEDESCRIPTORPOLLNG
  *
- * File descriptors are scanned in 3 steps.
- * First, scan all plug-ins, and processes after file descriptors to
- * watch, and add them with FD_SET(); added++;
+ * Modules and process pipes register their f_module_h once, with
+ * initng_io_fd_register() and initng_io_process_register(), the epoll
+ * instance keeps the set between the calls.
  *
- * Second, Run select if there where any added, with an timeout set
- * when function was called.
- *
- * Third, if select returns that there is data to fetch, walk over
- * plug-ins and file descriptors again, and call plug-ins or initng_process_readpipe
- * with pointer to module/service.
- *
- * This function will return FALSE, if it timeout, or if there was
- * no fds to monitor.
+ * This function waits up to timeout ms for any registered fd to get
+ * ready, and calls the owner of every ready fd directly, with the
+ * pointer that was registered.
  */
 void initng_io_module_poll(int timeout)
 {
-	/* Variables */
-	fd_set readset, writeset, errset;
-	struct timeval tv;
 	int retval;
-	int added = 0;
-	active_db_h *currentA, *qA;
-	process_h *currentP, *qP;
-	pipe_h *current_pipe;
+	int i;
 
-	/* initialization */
 	S_;
-	FD_ZERO(&readset);
-	FD_ZERO(&writeset);
-	FD_ZERO(&errset);
-
-	/* Set timeval struct, to our timeout */
-	tv.tv_sec = timeout;
-	tv.tv_usec = 0;
-
-	/*
-	 * STEP 1:  Scan for fds to add
-	 */
-
-	/* scan through active plug-ins that have listening file descriptors, and add them */
-	{
-		s_event event;
-		s_event_io_watcher_data data;
-
-		event.event_type = &EVENT_IO_WATCHER;
-		event.data = &data;
-		data.action = IOW_ACTION_CHECK;
-		data.added = 0;
-		data.readset = &readset;
-		data.writeset = &writeset;
-		data.errset = &errset;
-
-		initng_event_send(&event);
-
-		added += data.added;
-	}
-
-	/* Then add all file descriptors from process read pipes */
-	currentA = NULL;
-	while_active_db(currentA) {
-		currentP = NULL;
-		while_processes(currentP, currentA) {
-			current_pipe = NULL;
-			while_pipes(current_pipe, currentP) {
-				if ((current_pipe->dir == OUT_PIPE ||
-				     current_pipe->dir == BUFFERED_OUT_PIPE) &&
-				    current_pipe->pipe[0] > 2) {
-					/* expensive test to make sure the
-					 * pipe is open, before adding */
-					if (!STILL_OPEN(current_pipe->pipe[0])) {
-						D_("%i is not open anymore.\n",
-						   current_pipe->pipe[0]);
-						current_pipe->pipe[0] = -1;
-						continue;
-					}
-
-					FD_SET(current_pipe->pipe[0], &readset);
-					added++;
-				}
-
-				if (current_pipe->dir == IN_AND_OUT_PIPE &&
-				    current_pipe->pipe[1] > 2) {
-					/* expensive test to make sure the
-					 * pipe is open, before adding */
-					if (!STILL_OPEN(current_pipe->pipe[1])) {
-						D_("%i is not open anymore.\n",
-						   current_pipe->pipe[1]);
-						current_pipe->pipe[1] = -1;
-						continue;
-					}
-
-					FD_SET(current_pipe->pipe[1], &readset);
-					added++;
-				}
-
-				if (current_pipe->dir == IN_PIPE &&
-				    current_pipe->pipe[1] > 2) {
-					/* expensive test to make sure the
-					 * pipe is open, before adding */
-					if (!STILL_OPEN(current_pipe->pipe[1])) {
-						D_("%i is not open anymore.\n",
-						   current_pipe->pipe[1]);
-						current_pipe->pipe[1] = -1;
-						continue;
-					}
-
-					FD_SET(current_pipe->pipe[1],
-					       &writeset);
-					added++;
-				}
-			}
-		}
-	}
 
-	/*
-	 * STEP 2: Do the select-poll, if any fds where added
-	 */
-
-	/* check if there are any set */
-	if (added <= 0) {
-		D_("No file descriptors set.\n");
-		sleep(timeout);
+	if (!initng_io_epoll_open()) {
+		struct timespec nap = { timeout / 1000,
+			(timeout % 1000) * 1000000 };
+		nanosleep(&nap, NULL);
 		return;
 	}
-	D_("%i file descriptors added.\n", added);
 
-	/* make the select */
-	retval = select(256, &readset, &writeset, &errset, &tv);
+	retval = epoll_wait(initng_io_epoll_fd, initng_io_ready,
+			    IO_MAX_EVENTS, timeout);
 
 	/* error - Truly a interrupt */
 	if (retval < 0) {
-		D_("Select returned %i\n", retval);
+		D_("epoll_wait returned %i\n", retval);
 		return;
 	}
 
@@ -177,113 +72,34 @@ void initng_io_module_poll(int timeout)
 
 	D_("%d fd's active\n", retval);
 
-	/* If a fsck is running select will always return one file handler active, we give it 0.1 seconds to get some more data into the buffer. */
-	sleep(0.1);
-
 	/*
-	 * STEP 3:  Find the plug-ins/processes that handles the fd input, and call them
+	 * initng_io_fd_unregister() clears the entries in this list, if a
+	 * watch is removed by a callback before it is called.
 	 */
+	initng_io_ready_count = retval;
 
-	/* Now scan through callers */
-	{
-		s_event event;
-		s_event_io_watcher_data data;
-
-		event.event_type = &EVENT_IO_WATCHER;
-		event.data = &data;
-		data.action = IOW_ACTION_CALL;
-		data.readset = &readset;
-		data.writeset = &writeset;
-		data.errset = &errset;
-		data.added = retval;
-
-		initng_event_send(&event);
-
-		retval = data.added;
-		if (retval == 0)
-			return;
-	}
-
-	/* scan every service */
-	currentA = NULL;
-	qA = NULL;
-	while_active_db_safe(currentA, qA) {
-		currentP = NULL;
-		qP = NULL;
-		/* and all the processes */
-		while_processes_safe(currentP, qP, currentA) {
-			current_pipe = NULL;
+	for (i = 0; i < initng_io_ready_count; i++) {
+		f_module_h *fdw = initng_io_ready[i].data.ptr;
+		uint32_t events = initng_io_ready[i].events;
+		e_fdw what = 0;
 
-			/* check if this fd is a pipe bound to a process */
-			while_pipes(current_pipe, currentP) {
-				/* if a bufered output pipe is found . */
-				if (current_pipe->dir == BUFFERED_OUT_PIPE &&
-				    current_pipe->pipe[0] > 2 &&
-				    FD_ISSET(current_pipe->pipe[0], &readset)) {
-					D_("BUFFERED_OUT_PIPE: Will read "
-					   "from %s->start_process on fd "
-					   "#%i\n", currentA->name,
-					   current_pipe->pipe[0]);
+		/* unregistered while dispatching */
+		if (!fdw)
+			continue;
 
-					/* Do the actual read from pipe */
-					initng_io_process_read_input(currentA,
-								     currentP,
-								     current_pipe);
+		if (events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+			what |= fdw->what & IOW_READ;
+		if (events & (EPOLLOUT | EPOLLERR))
+			what |= fdw->what & IOW_WRITE;
+		if (events & (EPOLLPRI | EPOLLERR))
+			what |= fdw->what & IOW_ERROR;
 
-					/* Found match, that means we need to
-					 * look for one less, if we've found
-					 * all we should then return */
-					if (--retval == 0)
-						return;
-				}
-
-				if (current_pipe->dir == OUT_PIPE &&
-				    current_pipe->pipe[0] > 2 &&
-				    FD_ISSET(current_pipe->pipe[0], &readset)) {
-					initng_io_pipe(currentA, currentP,
-						       current_pipe);
-
-					/* Found match, that means we need to
-					 * look for one less, if we've found
-					 * all we should then return */
-					if (--retval == 0)
-						return;
-				}
-
-				if (current_pipe->dir == IN_AND_OUT_PIPE &&
-				    current_pipe->pipe[1] > 2 &&
-				    FD_ISSET(current_pipe->pipe[1], &readset)) {
-					initng_io_pipe(currentA, currentP,
-						       current_pipe);
-
-					/* Found match, that means we need to
-					 * look for one less, if we've found
-					 * all we should then return */
-					if (--retval == 0)
-						return;
-				}
-
-				if (current_pipe->dir == IN_PIPE &&
-				    current_pipe->pipe[1] > 2 &&
-				    FD_ISSET(current_pipe->pipe[1],
-					     &writeset)) {
-					initng_io_pipe(currentA, currentP,
-						       current_pipe);
-
-					/* Found match, that means we need to
-					 * look for one less, if we've found
-					 * all we should then return */
-					if (--retval == 0)
-						return;
-				}
-
-			}
-		}
-	}
+		/* a hangup on a write only fd, let the owner notice */
+		if (!what)
+			what = fdw->what;
 
-	if (retval != 0) {
-		F_("There is a missed pipe or fd that we missed to poll!\n");
+		fdw->call_module(fdw, what);
 	}
 
-	return;
+	initng_io_ready_count = 0;
 }
@@ -147,6 +147,7 @@ void initng_io_process_read_input(active_db_h * service, process_h * p,
 	 */
 	if (read_ret == 0) {
 		D_("Closing fifos for %s.\n", service->name);
+		initng_io_pipe_unregister(pi);
 		if (pi->pipe[0] > 0)
 			close(pi->pipe[0]);
 		if (pi->pipe[1] > 0)
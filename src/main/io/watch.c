@@ -0,0 +1,226 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include <sys/epoll.h>
+
+#include <initng.h>
+#include "local.h"
+
+int initng_io_epoll_fd = -1;
+struct epoll_event initng_io_ready[IO_MAX_EVENTS];
+int initng_io_ready_count = 0;
+
+/*
+ * The epoll instance is created on first use, it is close-on-exec so
+ * a hot reload will start over with a new one.
+ */
+int initng_io_epoll_open(void)
+{
+	if (initng_io_epoll_fd >= 0)
+		return TRUE;
+
+	initng_io_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (initng_io_epoll_fd < 0) {
+		F_("Could not create epoll instance: %s\n", strerror(errno));
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void fdw_to_epoll(f_module_h * fdw, struct epoll_event *ev)
+{
+	memset(ev, 0, sizeof(struct epoll_event));
+
+	if (fdw->what & IOW_READ)
+		ev->events |= EPOLLIN;
+	if (fdw->what & IOW_WRITE)
+		ev->events |= EPOLLOUT;
+	if (fdw->what & IOW_ERROR)
+		ev->events |= EPOLLPRI;
+
+	ev->data.ptr = fdw;
+}
+
+/*
+ * Add a watch, if fdw->fds is already watched the events are updated.
+ * The watch have to be unregistered before fdw->fds is closed.
+ */
+int initng_io_fd_register(f_module_h * fdw)
+{
+	struct epoll_event ev;
+
+	assert(fdw);
+	assert(fdw->call_module);
+
+	if (fdw->fds < 0 || !initng_io_epoll_open())
+		return FALSE;
+
+	fdw_to_epoll(fdw, &ev);
+
+	if (epoll_ctl(initng_io_epoll_fd, EPOLL_CTL_ADD, fdw->fds, &ev) == 0)
+		return TRUE;
+
+	if (errno == EEXIST)
+		return initng_io_fd_update(fdw);
+
+	F_("Could not watch fd %i: %s\n", fdw->fds, strerror(errno));
+	return FALSE;
+}
+
+/* call this when fdw->what has changed */
+int initng_io_fd_update(f_module_h * fdw)
+{
+	struct epoll_event ev;
+
+	assert(fdw);
+
+	if (fdw->fds < 0 || initng_io_epoll_fd < 0)
+		return FALSE;
+
+	fdw_to_epoll(fdw, &ev);
+
+	if (epoll_ctl(initng_io_epoll_fd, EPOLL_CTL_MOD, fdw->fds, &ev) < 0) {
+		F_("Could not update watch of fd %i: %s\n", fdw->fds,
+		   strerror(errno));
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+void initng_io_fd_unregister(f_module_h * fdw)
+{
+	int i;
+
+	assert(fdw);
+
+	/* make sure it wont be called if it is ready in this poll */
+	for (i = 0; i < initng_io_ready_count; i++) {
+		if (initng_io_ready[i].data.ptr == fdw)
+			initng_io_ready[i].data.ptr = NULL;
+	}
+
+	if (fdw->fds < 0 || initng_io_epoll_fd < 0)
+		return;
+
+	/* ENOENT and EBADF are fine, it was not watched */
+	epoll_ctl(initng_io_epoll_fd, EPOLL_CTL_DEL, fdw->fds, NULL);
+}
+
+/* called when a pipe registered below got ready */
+static void pipe_ready(f_module_h * fdw, e_fdw what)
+{
+	pipe_h *pi = initng_list_entry(fdw, pipe_h, fdw);
+
+	(void)what;
+
+	switch (pi->dir) {
+	case BUFFERED_OUT_PIPE:
+		D_("BUFFERED_OUT_PIPE: Will read from %s->%s on fd #%i\n",
+		   pi->service->name, pi->process->pt->name, pi->pipe[0]);
+		initng_io_process_read_input(pi->service, pi->process, pi);
+		break;
+	case OUT_PIPE:
+	case IN_PIPE:
+	case IN_AND_OUT_PIPE:
+		initng_io_pipe(pi->service, pi->process, pi);
+		break;
+	case UNKNOWN_PIPE:
+		break;
+	}
+}
+
+/*
+ * Watch the initng side of all pipes of a process, must be called
+ * after the fork, when the remote sides are closed.
+ */
+void initng_io_process_register(active_db_h * service, process_h * process)
+{
+	pipe_h *pi = NULL;
+
+	assert(service);
+	assert(process);
+
+	while_pipes(pi, process) {
+		/* already watched */
+		if (pi->fdw.call_module)
+			continue;
+
+		switch (pi->dir) {
+		case OUT_PIPE:
+		case BUFFERED_OUT_PIPE:
+			pi->fdw.fds = pi->pipe[0];
+			pi->fdw.what = IOW_READ;
+			break;
+		case IN_AND_OUT_PIPE:
+			pi->fdw.fds = pi->pipe[1];
+			pi->fdw.what = IOW_READ;
+			break;
+		case IN_PIPE:
+			pi->fdw.fds = pi->pipe[1];
+			pi->fdw.what = IOW_WRITE;
+			break;
+		case UNKNOWN_PIPE:
+			continue;
+		}
+
+		if (pi->fdw.fds <= 2)
+			continue;
+
+		pi->fdw.call_module = &pipe_ready;
+		pi->service = service;
+		pi->process = process;
+
+		if (!initng_io_fd_register(&pi->fdw)) {
+			pi->fdw.call_module = NULL;
+			pi->fdw.fds = -1;
+		}
+	}
+}
+
+/* stop watching a pipe, must be called before the pipe is closed */
+void initng_io_pipe_unregister(pipe_h * pi)
+{
+	assert(pi);
+
+	if (!pi->fdw.call_module)
+		return;
+
+	initng_io_fd_unregister(&pi->fdw);
+	pi->fdw.call_module = NULL;
+	pi->fdw.fds = -1;
+}
+
+void initng_io_process_unregister(process_h * process)
+{
+	pipe_h *pi = NULL;
+
+	assert(process);
+
+	while_pipes(pi, process) {
+		initng_io_pipe_unregister(pi);
+	}
+}
@@ -43,8 +43,8 @@ void initng_kill_handler_killed_by_pid(pid_t kpid, int r_code)
 	if (kpid <= 1)
 		return;
 
-	/* Look in process database for a match */
-	if (!(service = initng_active_db_find_by_pid(kpid))) {
+	/* Look in the pid index for a match */
+	if (!(process = initng_process_db_find_by_pid(kpid, &service))) {
 		D_("handle_killed_by_pid(%i): No match in active_db!\n", kpid);
 		return;
 	}
@@ -52,10 +52,10 @@ void initng_kill_handler_killed_by_pid(pid_t kpid, int r_code)
 	D_("handle_killed_by_pid(%i): found service \"%s\"...\n", kpid,
 	   service->name);
 
-	/* Get the process pointer from the service */
-	if (!(process = initng_process_db_get_by_pid(kpid, service))) {
-		W_("Could not fetch process, even when "
-		   "initng_active_db_find_by_pid() saw it here!\n");
+	/* Only handle processes that are still in use */
+	if (process->pst != P_ACTIVE) {
+		W_("Process %i of service %s is already freed!\n", kpid,
+		   service->name);
 		return;
 	}
 
@@ -75,11 +75,13 @@ void initng_kill_handler_killed_by_pid(pid_t kpid, int r_code)
 						     current_pipe);
 
 			/* now close */
+			initng_io_pipe_unregister(current_pipe);
 			close(current_pipe->pipe[0]);
 			current_pipe->pipe[0] = -1;
 		} else if ((current_pipe->dir == IN_PIPE ||
 			    current_pipe->dir == IN_AND_OUT_PIPE) &&
 			   current_pipe->pipe[1] > 0) {
+			initng_io_pipe_unregister(current_pipe);
 			close(current_pipe->pipe[1]);
 			current_pipe->pipe[1] = -1;
 		}
@@ -33,5 +33,8 @@ void initng_main_new_init(void)
 		return;
 	}
 	P_("\n\n\n          Launching new init (%s)\n\n", g.new_init[0]);
+
+	/* it may not be initng, don't leave signals blocked for it */
+	initng_signal_disable();
 	execve(g.new_init[0], g.new_init, environ);
 }
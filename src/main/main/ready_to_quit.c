@@ -34,24 +34,12 @@
  */
 int initng_main_ready_to_quit(void)
 {
-	active_db_h *current = NULL;
-
-	/* If the last process has died, quit initng */
-	while_active_db(current) {
-		/* Don't check with failed or down services */
-		switch (GET_STATE(current)) {
-		case IS_FAILED:
-		case IS_DOWN:
-			continue;
-		}
-
-		/*
-		 * if we got here,
-		 * its must be an non failing service,
-		 * left.
-		 */
+	/*
+	 * If the last process has died, quit initng, failed or down
+	 * services are not counted.
+	 */
+	if (initng_active_db_count(NULL) > 0)
 		return FALSE;
-	}
 
 	return TRUE;
 }
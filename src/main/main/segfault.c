@@ -23,6 +23,7 @@
 #include <fcntl.h>		/* fcntl() */
 #include <string.h>		/* memmove() strcmp() */
 #include <sys/wait.h>		/* waitpid() sa */
+#include <signal.h>		/* sigprocmask() */
 #include <sys/ioctl.h>		/* ioctl() */
 #include <stdlib.h>		/* free() exit() */
 #include <termios.h>
@@ -120,6 +121,11 @@ void initng_main_segfault(void)
 		const char *getty_argv[] =
 		    { "/sbin/getty", "38400", "tty9", NULL };
 		const char *getty_env[] = { NULL };
+		sigset_t none;
+
+		/* the blocked signals are inherited over execve */
+		sigemptyset(&none);
+		sigprocmask(SIG_SETMASK, &none, NULL);
 
 		/* execve getty in the fork */
 		execve((char *)getty_argv[0], (char **)getty_argv,
@@ -157,6 +163,11 @@ void initng_main_segfault(void)
 		const char *segfault_argv_initng[] =
 		    { "/sbin/initng", "--hot_reload", NULL };
 		const char *segfault_env[] = { NULL };
+		sigset_t none;
+
+		/* the blocked signals are inherited over execve */
+		sigemptyset(&none);
+		sigprocmask(SIG_SETMASK, &none, NULL);
 
 		/* first try /sbin/initng-segfault */
 		if (execve((char *)segfault_argv[0], (char **)segfault_argv,
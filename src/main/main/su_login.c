@@ -70,6 +70,9 @@ void initng_main_su_login(void)
 			const char *sulogin_argv[] = { "/sbin/sulogin", NULL };
 			const char *sulogin_env[] = { NULL };
 
+			/* our blocked signals would be inherited */
+			initng_signal_disable();
+
 			/* launch sulogin */
 			execve(sulogin_argv[0], (char **)sulogin_argv,
 			       (char **)sulogin_env);
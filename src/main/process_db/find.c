@@ -69,14 +69,11 @@ process_h *initng_process_db_get_by_name(const char *name,
  */
 process_h *initng_process_db_get_by_pid(pid_t pid, active_db_h * service)
 {
-	process_h *current = NULL;
+	active_db_h *owner = NULL;
+	process_h *current = initng_process_db_find_by_pid(pid, &owner);
 
-	while_processes(current, service) {
-		if (current->pst != P_ACTIVE)
-			continue;
-		if (current->pid == pid)
-			return current;
-	}
+	if (!current || owner != service || current->pst != P_ACTIVE)
+		return NULL;
 
-	return NULL;
+	return current;
 }
@@ -49,12 +49,14 @@ void initng_process_db_real_free(process_h * free_this)
 
 	/* Make sure this entry are not on any list */
 	initng_list_del(&free_this->list);
+	initng_process_db_unindex_pid(free_this);
 
 	while_pipes_safe(current_pipe, free_this, current_pipe_safe) {
 		/* unbound this pipe from list */
 		initng_list_del(&current_pipe->list);
 
-		/* close all pipes */
+		/* stop polling it, and close all pipes */
+		initng_io_pipe_unregister(current_pipe);
 		if (current_pipe->pipe[0] > 0)
 			close(current_pipe->pipe[0]);
 		if (current_pipe->pipe[1] > 0)
@@ -64,9 +66,9 @@ void initng_process_db_real_free(process_h * free_this)
 		free(current_pipe->buffer);
 
 		/* free it */
-		free(current_pipe);
+		initng_slab_free(&initng_slab_pipe, current_pipe);
 	}
 
-	free(free_this);
+	initng_slab_free(&initng_slab_process, free_this);
 	return;
 }
@@ -34,7 +34,7 @@ process_h *initng_process_db_new(ptype_h * type)
 	pipe_h *current_pipe;
 
 	/* allocate a new process entry */
-	new_p = (process_h *) initng_toolbox_calloc(1, sizeof(process_h));
+	new_p = (process_h *) initng_slab_alloc(&initng_slab_process);
 	if (!new_p) {
 		F_("Unable to allocate process!\n");
 		return NULL;
@@ -57,7 +57,7 @@ process_h *initng_process_db_new(ptype_h * type)
 	/* create the output pipe */
 	current_pipe = initng_process_db_pipe_new(BUFFERED_OUT_PIPE);
 	if (!current_pipe) {
-		free(new_p);
+		initng_slab_free(&initng_slab_process, new_p);
 		return NULL;
 	}
 
@@ -0,0 +1,170 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#define PID_INDEX_MIN_SIZE 64
+#define PID_DELETED ((pid_t) -1)
+
+/*
+ * An open addressed table from pid to the process and service owning it,
+ * so a reaped child is found without walking every service. A slot with
+ * pid 0 was never used, PID_DELETED marks a removed entry.
+ */
+typedef struct {
+	pid_t pid;
+	active_db_h *service;
+	process_h *process;
+} s_pid_entry;
+
+static s_pid_entry *slots = NULL;
+static size_t size = 0;		/* always a power of two */
+static size_t used = 0;		/* live entries */
+static size_t filled = 0;	/* live entries and deleted slots */
+
+static size_t probe(pid_t pid, size_t i)
+{
+	return ((uint32_t) pid * 2654435761U + i) & (size - 1);
+}
+
+static s_pid_entry *lookup(pid_t pid)
+{
+	size_t i;
+
+	if (!used)
+		return NULL;
+
+	for (i = 0; slots[probe(pid, i)].pid; i++) {
+		if (slots[probe(pid, i)].pid == pid)
+			return &slots[probe(pid, i)];
+	}
+
+	return NULL;
+}
+
+static void rehash(size_t new_size)
+{
+	s_pid_entry *old = slots;
+	size_t old_size = size;
+	size_t i, j;
+
+	slots = initng_toolbox_calloc(new_size, sizeof(s_pid_entry));
+	size = new_size;
+	filled = used;
+
+	for (i = 0; i < old_size; i++) {
+		if (old[i].pid <= 0)
+			continue;
+
+		for (j = 0; slots[probe(old[i].pid, j)].pid; j++) ;
+		slots[probe(old[i].pid, j)] = old[i];
+	}
+
+	free(old);
+}
+
+static void insert(pid_t pid, active_db_h * service, process_h * process)
+{
+	s_pid_entry *entry;
+	size_t i;
+
+	/* the pid has been reused, the latest owner wins */
+	if ((entry = lookup(pid))) {
+		entry->service = service;
+		entry->process = process;
+		return;
+	}
+
+	/* keep the table at most half full, counting deleted slots */
+	if ((filled + 1) * 2 > size) {
+		size_t new_size = PID_INDEX_MIN_SIZE;
+
+		while ((used + 1) * 2 > new_size / 2)
+			new_size *= 2;
+		rehash(new_size);
+	}
+
+	for (i = 0; slots[probe(pid, i)].pid > 0; i++) ;
+	entry = &slots[probe(pid, i)];
+
+	if (!entry->pid)
+		filled++;
+	entry->pid = pid;
+	entry->service = service;
+	entry->process = process;
+	used++;
+}
+
+/*
+ * Remove process from the pid index, process->pid is left as it is.
+ */
+void initng_process_db_unindex_pid(process_h * process)
+{
+	s_pid_entry *entry;
+
+	assert(process);
+
+	if (process->pid <= 0 || !(entry = lookup(process->pid)))
+		return;
+
+	/* the pid might have been taken over by a newer process */
+	if (entry->process != process)
+		return;
+
+	entry->pid = PID_DELETED;
+	entry->service = NULL;
+	entry->process = NULL;
+	used--;
+}
+
+/*
+ * Set the pid of a process owned by service, and index it. Always set
+ * process->pid through this.
+ */
+void initng_process_db_set_pid(process_h * process, active_db_h * service,
+			       pid_t pid)
+{
+	assert(process);
+
+	initng_process_db_unindex_pid(process);
+	process->pid = pid;
+
+	if (pid > 0 && service)
+		insert(pid, service, process);
+}
+
+/*
+ * Find the process with pid, and the service it belongs to.
+ */
+process_h *initng_process_db_find_by_pid(pid_t pid, active_db_h ** service)
+{
+	s_pid_entry *entry;
+
+	if (pid <= 0 || !(entry = lookup(pid)))
+		return NULL;
+
+	if (service)
+		*service = entry->service;
+	return entry->process;
+}
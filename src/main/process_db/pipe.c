@@ -33,7 +33,7 @@
  */
 pipe_h *initng_process_db_pipe_new(e_dir dir)
 {
-	pipe_h *pipe_struct = initng_toolbox_calloc(1, sizeof(pipe_h));
+	pipe_h *pipe_struct = initng_slab_alloc(&initng_slab_pipe);
 
 	if (!pipe_struct)
 		return NULL;
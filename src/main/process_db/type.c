@@ -31,13 +31,28 @@
  * Browse ptypes, search by name
  */
 ptype_h *initng_process_db_ptype_find(const char *name)
+{
+	assert(name);
+
+	return initng_symbol_find(SYMBOL_PTYPE, name);
+}
+
+void initng_process_db_ptype_unregister(ptype_h * pt)
 {
 	ptype_h *found = NULL;
 
+	assert(pt);
+
+	initng_list_del(&pt->list);
+
+	/* if another type had the same name, it is found from now on */
+	if (!initng_symbol_del(SYMBOL_PTYPE, pt->name, pt))
+		return;
+
 	while_ptypes(found) {
-		if (strcmp(name, found->name) == 0)
-			return found;
+		if (strcmp(found->name, pt->name) == 0) {
+			initng_symbol_add(SYMBOL_PTYPE, found->name, found);
+			return;
+		}
 	}
-
-	return NULL;
 }
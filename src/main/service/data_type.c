@@ -68,6 +68,8 @@ void initng_service_data_type_register(s_entry * ent)
 
 	/* add the option to the option_db list */
 	initng_list_add(&ent->list, &g.option_db.list);
+	if (ent->name)
+		initng_symbol_add(SYMBOL_OPTION, ent->name, ent);
 #ifdef DEBUG
 	if (ent->name)
 		D_(" \"%s\" added to option_db!\n", ent->name);
@@ -93,6 +95,20 @@ void initng_service_data_type_unregister(s_entry * ent)
 
 	/* remove it from the list */
 	initng_list_del(&ent->list);
+
+	/* if another option had the same name, it is found from now on */
+	if (ent->name && initng_symbol_del(SYMBOL_OPTION, ent->name, ent)) {
+		s_entry *current = NULL;
+
+		while_service_data_types(current) {
+			if (current->name &&
+			    strcmp(current->name, ent->name) == 0) {
+				initng_symbol_add(SYMBOL_OPTION, current->name,
+						  current);
+				break;
+			}
+		}
+	}
 }
 
 /*
@@ -118,16 +134,9 @@ void initng_service_data_type_unregister_all(void)
  */
 s_entry *initng_service_data_type_find(const char *string)
 {
-	s_entry *current = NULL;
-
 	S_;
 	assert(string);
 	D_("looking for %s.\n", string);
 
-	while_service_data_types(current) {
-		if (current->name && strcmp(current->name, string) == 0)
-			return current;
-	}
-
-	return NULL;
+	return initng_symbol_find(SYMBOL_OPTION, string);
 }
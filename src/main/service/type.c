@@ -21,10 +21,34 @@
 
 #include <initng.h>
 
+void initng_service_type_unregister(stype_h * st)
+{
+	stype_h *current = NULL;
+
+	initng_list_del(&st->list);
+
+	/* if another type had the same name, it is found from now on */
+	if (!st->name || !initng_symbol_del(SYMBOL_STYPE, st->name, st))
+		return;
+
+	while_service_types(current) {
+		if (current->name && strcmp(current->name, st->name) == 0) {
+			initng_symbol_add(SYMBOL_STYPE, current->name,
+					  current);
+			return;
+		}
+	}
+}
+
 stype_h *initng_service_type_get_by_name(const char *name)
 {
 	stype_h *current = NULL;
 
+	/* an exact match first */
+	if ((current = initng_symbol_find(SYMBOL_STYPE, name)))
+		return current;
+
+	/* else the first type that name starts with */
 	while_service_types(current) {
 		if (strncmp(current->name, name, current->name_len) == 0)
 			return current;
@@ -18,31 +18,145 @@
  */
 
 #include <signal.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#ifdef __linux__
+#include <sys/signalfd.h>
+#endif
 
 #include <initng.h>
 
-void initng_signal_dispatch(void)
+#include "local.h"
+
+/* number of signals read at once */
+#define SIGNAL_BATCH 32
+
+static void handle_signal(int sig)
+{
+	initng_module_callers_signal(sig);
+
+	switch (sig) {
+	/* dead children */
+	case SIGCHLD:
+		initng_signal_handle_sigchild();
+		break;
+	case SIGALRM:
+		initng_timer_run();
+		break;
+	default:
+		break;
+	}
+}
+
+#ifdef __linux__
+/*
+ * Reap the child the kernel told us about, without a search for it.
+ * SIGCHLD is not queued, so initng_signal_handle_sigchild() still runs
+ * once per batch, to get the ones that was merged into this one.
+ */
+static void reap_child(struct signalfd_siginfo *si)
 {
-	for (int i = 0; i < SIGNAL_STACK; i++) {
-		if (g.signals_got[i] == -1)
-			continue;
+	int status;
+	pid_t killed;
+
+	if (si->ssi_code != CLD_EXITED && si->ssi_code != CLD_KILLED &&
+	    si->ssi_code != CLD_DUMPED)
+		return;
+
+	do {
+		killed = waitpid(si->ssi_pid, &status, WNOHANG);
+	} while (killed < 0 && errno == EINTR);
+
+	if (killed != (pid_t) si->ssi_pid)
+		return;
+
+	D_("reap_child(): PID %i exited with status %i\n", killed,
+	   si->ssi_status);
+
+	initng_kill_handler_killed_by_pid(killed, status);
+}
+
+static void dispatch_signalfd(void)
+{
+	struct signalfd_siginfo si[SIGNAL_BATCH];
+	ssize_t len;
+	int got_child;
+
+	do {
+		len = read(signal_fdw.fds, si, sizeof(si));
+		if (len < (ssize_t) sizeof(struct signalfd_siginfo)) {
+			if (len < 0 && errno == EINTR)
+				continue;
+			return;
+		}
 
-		/* reset the signal slot */
-		int sig = g.signals_got[i];
-		g.signals_got[i] = -1;
+		got_child = FALSE;
 
-		initng_module_callers_signal(sig);
+		for (int i = 0; i < len / (ssize_t) sizeof(si[0]); i++) {
+			int sig = si[i].ssi_signo;
 
-		switch (sig) {
-		/* dead children */
-		case SIGCHLD:
+			if (sig != SIGCHLD) {
+				handle_signal(sig);
+				continue;
+			}
+
+			initng_module_callers_signal(sig);
+			reap_child(&si[i]);
+			got_child = TRUE;
+		}
+
+		if (got_child)
 			initng_signal_handle_sigchild();
-			break;
-		case SIGALRM:
-			initng_handler_run_alarm();
-			break;
-		default:
-			break;
+	}
+	/* the buffer was filled, there might be more */
+	while (len == sizeof(si));
+}
+#endif
+
+static void dispatch_pipe(void)
+{
+	unsigned char buf[SIGNAL_BATCH];
+	char seen[256] = { 0 };
+	ssize_t len;
+
+	do {
+		len = read(signal_fdw.fds, buf, sizeof(buf));
+		if (len <= 0) {
+			if (len < 0 && errno == EINTR)
+				continue;
+			return;
+		}
+
+		for (int i = 0; i < len; i++) {
+			/* one call per signal is enough */
+			if (seen[buf[i]])
+				continue;
+			seen[buf[i]] = TRUE;
+
+			handle_signal(buf[i]);
 		}
 	}
+	while (len == sizeof(buf));
+}
+
+/*
+ * Read all signals pending, called on top of every main loop, and the
+ * poll returns as soon as the signal fd gets readable.
+ */
+void initng_signal_dispatch(void)
+{
+	if (signal_fdw.fds < 0)
+		return;
+
+#ifdef __linux__
+	if (signal_use_signalfd) {
+		dispatch_signalfd();
+		return;
+	}
+#endif
+
+	dispatch_pipe();
 }
@@ -22,4 +22,8 @@
 
 void sigsegv(int sig);
 
+/* the signalfd, or the read end of the signal pipe */
+extern f_module_h signal_fdw;
+extern int signal_use_signalfd;
+
 #endif
@@ -25,6 +25,11 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/signalfd.h>
+#endif
 
 #include <initng.h>
 
@@ -33,34 +38,78 @@
 
 struct sigaction sa;
 
+/* the signals we read from signal_fdw.fds, instead of by a handler */
+static sigset_t sig_mask;
+
+static void signal_ready(f_module_h * from, e_fdw what);
+
+f_module_h signal_fdw = {
+	.call_module = &signal_ready,
+	.what = IOW_READ,
+	.fds = -1
+};
+
+int signal_use_signalfd = FALSE;
+
+/* write end of the self-pipe, if signalfd is not available */
+static int self_pipe = -1;
+
+/*
+ * Only wake up the poll, initng_signal_dispatch() is run on top of
+ * every main loop.
+ */
+static void signal_ready(f_module_h * from, e_fdw what)
+{
+	(void)from;
+	(void)what;
+
+	D_("Got a signal, waking up.\n");
+}
+
 static void set_signal(int sig)
 {
-	for (int i = 0; i < SIGNAL_STACK; i++) {
-		/* Check if this signal type is already on the list */
-		if (g.signals_got[i] == sig)
-			return;
-
-		/* else add this on a free spot */
-		if (g.signals_got[i] == -1) {
-			g.signals_got[i] = sig;
-			return;
-		}
+	unsigned char c = sig;
+	int saved_errno = errno;
+
+	/* if the pipe is full, there is plenty of wakeups in it already */
+	if (write(self_pipe, &c, 1) < 0 && errno != EAGAIN)
+		F_("Could not queue signal %i!\n", sig);
+
+	errno = saved_errno;
+}
+
+static int open_self_pipe(void)
+{
+	int fds[2];
+
+	if (pipe(fds) < 0) {
+		F_("Could not create signal pipe: %s\n", strerror(errno));
+		return FALSE;
+	}
+
+	for (int i = 0; i < 2; i++) {
+		fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL, 0) | O_NONBLOCK);
+		initng_io_set_cloexec(fds[i]);
 	}
-	F_("SIGNAL STACK FULL!\n");
+
+	signal_fdw.fds = fds[0];
+	self_pipe = fds[1];
+	return TRUE;
 }
 
 /**
  * Enable signals, called from main() on initialization.
+ *
+ * The signals are blocked and read from a signalfd, that is polled in
+ * the main loop together with all other fds. If there is no signalfd,
+ * the handler writes them to a pipe polled the same way.
  */
 void initng_signal_enable(void)
 {
 	S_;
 
-	/* clear interrupt cache */
 	/* TODO FIGUREITOUT - Catch signals */
 	/*  signal(SIGPWR,sighandler); don't know what to do about it */
-	/*  signal(SIGHUP,sighandler); signal for plug-ins to do something */
-	/*  (recreate control file for example) */
 	/* SA_NOCLDSTOP -->  Get notification when child stops living */
 	/* SA_RESTART --> make certain system calls restartable across signals */
 	/*   Normally if a program is in a system call and a signal is */
@@ -78,10 +127,6 @@ void initng_signal_enable(void)
 	sa.sa_sigaction = 0;
 #endif
 
-	/* clear signal */
-	for (int i = 0; i < SIGNAL_STACK; i++)
-		g.signals_got[i] = -1;
-
 	/* SA_NOCLDSTOP = Don't give initng signal if we kill the app with SIGSTOP */
 	/* SA_RESTART = call signal over again next time */
 	sa.sa_flags = SA_RESTART | SA_NOCLDSTOP;
@@ -91,18 +136,55 @@ void initng_signal_enable(void)
 	sigaction(SIGSEGV, &sa, 0);
 	sigaction(SIGABRT, &sa, 0);
 
-	sa.sa_handler = set_signal;
-	sigaction(SIGCHLD, &sa, 0);	/* Dead children */
-	sigaction(SIGINT, &sa, 0);	/* ctrl-alt-del */
-	sigaction(SIGWINCH, &sa, 0);	/* keyboard request */
-	sigaction(SIGALRM, &sa, 0);	/* alarm, something has to */
+	sigemptyset(&sig_mask);
+	sigaddset(&sig_mask, SIGCHLD);	/* Dead children */
+	sigaddset(&sig_mask, SIGINT);	/* ctrl-alt-del */
+	sigaddset(&sig_mask, SIGWINCH);	/* keyboard request */
+	sigaddset(&sig_mask, SIGALRM);	/* alarm, something has to */
 	/* be checked */
-	sigaction(SIGHUP, &sa, 0);	/* sighup, module actions */
-	sigaction(SIGPIPE, &sa, 0);	/* sigpipe, module actions */
+	sigaddset(&sig_mask, SIGHUP);	/* sighup, module actions */
+	sigaddset(&sig_mask, SIGPIPE);	/* sigpipe, module actions */
+
+	/* already open, after a hot reload it is closed by exec */
+	if (signal_fdw.fds >= 0)
+		return;
+
+#ifdef __linux__
+	signal_fdw.fds = signalfd(-1, &sig_mask, SFD_NONBLOCK | SFD_CLOEXEC);
+	if (signal_fdw.fds >= 0) {
+		signal_use_signalfd = TRUE;
+
+		/* keep SA_NOCLDSTOP, for a default action */
+		sa.sa_handler = SIG_DFL;
+		sigaction(SIGCHLD, &sa, 0);
+
+		sigprocmask(SIG_BLOCK, &sig_mask, NULL);
+		initng_io_fd_register(&signal_fdw);
+		return;
+	}
+
+	W_("signalfd failed (%s), using a signal pipe.\n", strerror(errno));
+#endif
+
+	if (!open_self_pipe())
+		return;
+
+	sa.sa_handler = set_signal;
+	sigaction(SIGCHLD, &sa, 0);
+	sigaction(SIGINT, &sa, 0);
+	sigaction(SIGWINCH, &sa, 0);
+	sigaction(SIGALRM, &sa, 0);
+	sigaction(SIGHUP, &sa, 0);
+	sigaction(SIGPIPE, &sa, 0);
+
+	/* signals blocked by a hot reload from a signalfd initng */
+	sigprocmask(SIG_UNBLOCK, &sig_mask, NULL);
+
+	initng_io_fd_register(&signal_fdw);
 }
 
 /**
- * Disable signals, called when initng is exiting.
+ * Disable signals, called when initng is exiting, and in every fork.
  * Sometimes we don't want to be disturbed.
  */
 void initng_signal_disable(void)
@@ -126,4 +208,8 @@ void initng_signal_disable(void)
 	sigaction(SIGWINCH, &sa, 0);	/* keyboard request */
 	sigaction(SIGALRM, &sa, 0);	/* alarm, something has to be checked */
 	sigaction(SIGHUP, &sa, 0);	/* sighup, module actions */
+	sigaction(SIGPIPE, &sa, 0);	/* sigpipe, module actions */
+
+	/* the mask is inherited over execve, so unblock for the child */
+	sigprocmask(SIG_UNBLOCK, &sig_mask, NULL);
 }
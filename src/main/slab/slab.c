@@ -0,0 +1,136 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define SLAB_ALIGN 16
+
+s_slab_cache initng_slab_active_db =
+    SLAB_CACHE("active_db", active_db_h, 32, 8);
+s_slab_cache initng_slab_process = SLAB_CACHE("process", process_h, 32, 8);
+s_slab_cache initng_slab_pipe = SLAB_CACHE("pipe", pipe_h, 32, 8);
+s_slab_cache initng_slab_data = SLAB_CACHE("data", s_data, 256, 64);
+
+static list_t caches = LIST_HEAD_INIT(caches);
+
+static size_t record_size(s_slab_cache * cache)
+{
+	return (cache->size + SLAB_ALIGN - 1) & ~(size_t) (SLAB_ALIGN - 1);
+}
+
+static void push(s_slab_cache * cache, void *ptr)
+{
+	*(void **)ptr = cache->free_list;
+	cache->free_list = ptr;
+	cache->free_count++;
+}
+
+/*
+ * Add one slab of records to the free list, without waiting for memory.
+ */
+static int grow(s_slab_cache * cache)
+{
+	size_t size = record_size(cache);
+	char *slab;
+	int i;
+
+	/* first use, list it for the statistics */
+	if (!cache->list.next)
+		initng_list_add_tail(&cache->list, &caches);
+
+	if (!(slab = malloc(size * cache->per_slab))) {
+		cache->grow_failed++;
+		return FALSE;
+	}
+
+	/* push backwards, so records are handed out in address order */
+	for (i = cache->per_slab - 1; i >= 0; i--)
+		push(cache, slab + i * size);
+
+	cache->slabs++;
+	return TRUE;
+}
+
+void *initng_slab_alloc(s_slab_cache * cache)
+{
+	void *ptr;
+
+	assert(cache);
+
+	if (!cache->free_list && !grow(cache)) {
+		/* the reserve is gone as well, wait for memory */
+		F_("Out of memory for %s records!\n", cache->name);
+		if (!cache->list.next)
+			initng_list_add_tail(&cache->list, &caches);
+		ptr = initng_toolbox_calloc(1, record_size(cache));
+		push(cache, ptr);
+	}
+
+	ptr = cache->free_list;
+	cache->free_list = *(void **)ptr;
+	cache->free_count--;
+
+	/* refill the reserve while memory is there */
+	if (cache->free_count < cache->reserve)
+		grow(cache);
+
+	cache->allocs++;
+	if (++cache->in_use > cache->peak)
+		cache->peak = cache->in_use;
+
+	memset(ptr, 0, cache->size);
+	return ptr;
+}
+
+void initng_slab_free(s_slab_cache * cache, void *ptr)
+{
+	assert(cache);
+
+	if (!ptr)
+		return;
+
+	push(cache, ptr);
+	cache->frees++;
+	cache->in_use--;
+}
+
+char *initng_slab_stats(void)
+{
+	s_slab_cache *current = NULL;
+	char *string = NULL;
+
+	initng_string_mprintf(&string, "%-12s %6s %6s %8s %8s %6s %10s %10s "
+			      "%6s\n", "cache", "size", "slabs", "in_use",
+			      "free", "peak", "allocs", "frees", "failed");
+
+	initng_list_foreach(current, &caches, list) {
+		initng_string_mprintf(&string, "%-12s %6zu %6i %8i %8i %6i "
+				      "%10lu %10lu %6lu\n", current->name,
+				      record_size(current), current->slabs,
+				      current->in_use, current->free_count,
+				      current->peak, current->allocs,
+				      current->frees, current->grow_failed);
+	}
+
+	return string;
+}
@@ -0,0 +1,147 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+
+#include <string.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#define SYMBOL_MIN_SIZE 256
+
+typedef struct {
+	const char *name;	/* NULL if never used */
+	hash_t hash;
+	e_symbol kind;		/* 0 if deleted */
+	void *ptr;
+} s_symbol;
+
+static s_symbol *slots = NULL;
+static size_t size = 0;		/* always a power of two */
+static size_t used = 0;		/* live entries */
+static size_t filled = 0;	/* live entries and deleted slots */
+
+static size_t probe(hash_t hash, size_t i)
+{
+	return (hash + i) & (size - 1);
+}
+
+static hash_t symbol_hash(e_symbol kind, const char *name)
+{
+	return initng_hash_str(name) ^ ((hash_t) kind * 0x9e3779b9U);
+}
+
+static s_symbol *lookup(e_symbol kind, const char *name, hash_t hash)
+{
+	size_t i, slot;
+
+	if (!used)
+		return NULL;
+
+	for (i = 0; slots[slot = probe(hash, i)].name; i++) {
+		if (slots[slot].kind == kind && slots[slot].hash == hash &&
+		    strcmp(slots[slot].name, name) == 0)
+			return &slots[slot];
+	}
+
+	return NULL;
+}
+
+static void rehash(size_t new_size)
+{
+	s_symbol *old = slots;
+	size_t old_size = size;
+	size_t i, j;
+
+	slots = initng_toolbox_calloc(new_size, sizeof(s_symbol));
+	size = new_size;
+	filled = used;
+
+	for (i = 0; i < old_size; i++) {
+		if (!old[i].kind)
+			continue;
+
+		for (j = 0; slots[probe(old[i].hash, j)].name; j++) ;
+		slots[probe(old[i].hash, j)] = old[i];
+	}
+
+	free(old);
+}
+
+int initng_symbol_add(e_symbol kind, const char *name, void *ptr)
+{
+	hash_t hash;
+	size_t i, slot;
+
+	assert(name);
+	assert(ptr);
+
+	hash = symbol_hash(kind, name);
+	if (lookup(kind, name, hash))
+		return FALSE;
+
+	/* keep the table at most half full, counting deleted slots */
+	if ((filled + 1) * 2 > size) {
+		size_t new_size = SYMBOL_MIN_SIZE;
+
+		while ((used + 1) * 2 > new_size / 2)
+			new_size *= 2;
+		rehash(new_size);
+	}
+
+	for (i = 0; slots[slot = probe(hash, i)].kind; i++) ;
+
+	if (!slots[slot].name)
+		filled++;
+	slots[slot].name = name;
+	slots[slot].hash = hash;
+	slots[slot].kind = kind;
+	slots[slot].ptr = ptr;
+	used++;
+
+	return TRUE;
+}
+
+int initng_symbol_del(e_symbol kind, const char *name, void *ptr)
+{
+	s_symbol *symbol;
+
+	assert(name);
+
+	symbol = lookup(kind, name, symbol_hash(kind, name));
+	if (!symbol || symbol->ptr != ptr)
+		return FALSE;
+
+	/* leave name set, so probes continue past this slot */
+	symbol->kind = 0;
+	symbol->ptr = NULL;
+	used--;
+
+	return TRUE;
+}
+
+void *initng_symbol_find(e_symbol kind, const char *name)
+{
+	s_symbol *symbol;
+
+	assert(name);
+
+	symbol = lookup(kind, name, symbol_hash(kind, name));
+	return symbol ? symbol->ptr : NULL;
+}
@@ -0,0 +1,135 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include <initng.h>
+#include "local.h"
+
+s_timer **initng_timer_heap = NULL;
+int initng_timer_heap_len = 0;
+static int heap_size = 0;
+
+static void heap_set(int i, s_timer * timer)
+{
+	initng_timer_heap[i] = timer;
+	timer->index = i;
+}
+
+static void sift_up(int i)
+{
+	s_timer *timer = initng_timer_heap[i];
+
+	while (i > 0) {
+		int parent = (i - 1) / 2;
+
+		if (initng_timer_heap[parent]->due <= timer->due)
+			break;
+
+		heap_set(i, initng_timer_heap[parent]);
+		i = parent;
+	}
+
+	heap_set(i, timer);
+}
+
+static void sift_down(int i)
+{
+	s_timer *timer = initng_timer_heap[i];
+
+	for (;;) {
+		int child = 2 * i + 1;
+
+		if (child >= initng_timer_heap_len)
+			break;
+
+		/* take the earliest of the two children */
+		if (child + 1 < initng_timer_heap_len &&
+		    initng_timer_heap[child + 1]->due <
+		    initng_timer_heap[child]->due)
+			child++;
+
+		if (timer->due <= initng_timer_heap[child]->due)
+			break;
+
+		heap_set(i, initng_timer_heap[child]);
+		i = child;
+	}
+
+	heap_set(i, timer);
+}
+
+void initng_timer_heap_remove(s_timer * timer)
+{
+	int i = timer->index;
+	s_timer *last;
+
+	assert(i >= 0 && i < initng_timer_heap_len);
+	assert(initng_timer_heap[i] == timer);
+
+	timer->index = -1;
+	last = initng_timer_heap[--initng_timer_heap_len];
+
+	/* it was the last one */
+	if (last == timer)
+		return;
+
+	/* move the last into the hole, and restore the order */
+	heap_set(i, last);
+	if (i > 0 && initng_timer_heap[(i - 1) / 2]->due > last->due)
+		sift_up(i);
+	else
+		sift_down(i);
+}
+
+void initng_timer_arm(s_timer * timer, int ms)
+{
+	assert(timer);
+	assert(timer->call);
+
+	if (ms < 0)
+		ms = 0;
+
+	if (initng_timer_is_armed(timer))
+		initng_timer_heap_remove(timer);
+
+	timer->due = initng_timer_now() + ms;
+
+	/* make room */
+	if (initng_timer_heap_len >= heap_size) {
+		int new_size = heap_size ? heap_size * 2 : 64;
+
+		initng_timer_heap = initng_toolbox_realloc(initng_timer_heap,
+							   new_size *
+							   sizeof(s_timer *));
+		heap_size = new_size;
+	}
+
+	heap_set(initng_timer_heap_len++, timer);
+	sift_up(timer->index);
+}
+
+void initng_timer_cancel(s_timer * timer)
+{
+	assert(timer);
+
+	if (initng_timer_is_armed(timer))
+		initng_timer_heap_remove(timer);
+}
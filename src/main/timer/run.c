@@ -0,0 +1,65 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <time.h>
+#include <assert.h>
+
+#include <initng.h>
+#include "local.h"
+
+uint64_t initng_timer_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+int initng_timer_next(void)
+{
+	uint64_t now;
+
+	if (initng_timer_heap_len == 0)
+		return -1;
+
+	now = initng_timer_now();
+	if (initng_timer_heap[0]->due <= now)
+		return 0;
+
+	return (int)(initng_timer_heap[0]->due - now);
+}
+
+/*
+ * Call all timers that are due.
+ * A timer that re-arms itself to 0 ms is not called again in this run,
+ * so this is limited to the timers armed when it was called.
+ */
+void initng_timer_run(void)
+{
+	int max = initng_timer_heap_len;
+	uint64_t now = initng_timer_now();
+
+	while (max-- > 0 && initng_timer_heap_len > 0 &&
+	       initng_timer_heap[0]->due <= now) {
+		s_timer *timer = initng_timer_heap[0];
+
+		initng_timer_heap_remove(timer);
+		(*timer->call) (timer);
+	}
+}
@@ -45,11 +45,11 @@ s_entry CHDIR = {
 
 static void do_chdir(s_event * event)
 {
-	s_event_after_fork_data *data;
+	s_event_spawn_plan_data *data;
 
 	const char *tmp = NULL;
 
-	assert(event->event_type == &EVENT_AFTER_FORK);
+	assert(event->event_type == &EVENT_SPAWN_PLAN);
 	assert(event->data);
 
 	data = event->data;
@@ -67,20 +67,18 @@ static void do_chdir(s_event * event)
 
 	D_("CHDIR TO %s\n", tmp);
 
-	if (chdir(tmp) == -1) {
-		F_("Chdir failed with %s\n", strerror(errno));
-		event->status = FAILED;
-	}
+	/* the child does it */
+	data->plan->chdir = tmp;
 }
 
 int module_init(void)
 {
 	initng_service_data_type_register(&CHDIR);
-	return (initng_event_hook_register(&EVENT_AFTER_FORK, &do_chdir));
+	return (initng_event_hook_register(&EVENT_SPAWN_PLAN, &do_chdir));
 }
 
 void module_unload(void)
 {
 	initng_service_data_type_unregister(&CHDIR);
-	initng_event_hook_unregister(&EVENT_AFTER_FORK, &do_chdir);
+	initng_event_hook_unregister(&EVENT_SPAWN_PLAN, &do_chdir);
 }
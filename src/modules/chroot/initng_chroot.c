@@ -48,11 +48,11 @@ s_entry CHROOT = {
 
 static void do_chroot(s_event * event)
 {
-	s_event_after_fork_data *data;
+	s_event_spawn_plan_data *data;
 
 	const char *tmp = NULL;
 
-	assert(event->event_type == &EVENT_AFTER_FORK);
+	assert(event->event_type == &EVENT_SPAWN_PLAN);
 	assert(event->data);
 
 	data = event->data;
@@ -67,27 +67,18 @@ static void do_chroot(s_event * event)
 		return;
 	}
 
-	if (chdir(tmp) == -1) {
-		F_("Chdir %s failed with %s\n", tmp, strerror(errno));
-		event->status = FAILED;
-		return;
-	}
-
-	if (chroot(tmp) == -1) {
-		F_("Chroot %s failed with %s\n", tmp, strerror(errno));
-		event->status = FAILED;
-		return;
-	}
+	/* the child changes to it, and chroots */
+	data->plan->chroot = tmp;
 }
 
 int module_init(void)
 {
 	initng_service_data_type_register(&CHROOT);
-	return (initng_event_hook_register(&EVENT_AFTER_FORK, &do_chroot));
+	return (initng_event_hook_register(&EVENT_SPAWN_PLAN, &do_chroot));
 }
 
 void module_unload(void)
 {
 	initng_service_data_type_unregister(&CHROOT);
-	initng_event_hook_unregister(&EVENT_AFTER_FORK, &do_chroot);
+	initng_event_hook_unregister(&EVENT_SPAWN_PLAN, &do_chroot);
 }
@@ -61,6 +61,11 @@ const struct initng_module initng_module = {
  */
 #define PID_TIMEOUT 60
 
+/*
+ * How often (in ms) to look for the pidfile while waiting for it.
+ */
+#define PID_POLL 100
+
 /*
  * Rate limit on missing pidfile warnings
  */
@@ -796,7 +801,8 @@ static void init_DAEMON_START_DEPS_MET(active_db_h * daemon)
 				   "one.\n", daemon->name);
 
 				/* set process status */
-				existing_process->pid = pid;
+				initng_process_db_set_pid(existing_process,
+							  daemon, pid);
 
 				/* add process */
 				initng_process_db_register_to_service
@@ -901,12 +907,12 @@ static void init_DAEMON_STOP_DEPS_MET(active_db_h * service)
 }
 
 /*
- * Set an alarm to 1 seconds .
+ * Set an alarm to PID_POLL ms.
  */
 static void init_DAEMON_WAIT_FOR_PID_FILE(active_db_h * s)
 {
-	/* Set the alarm to 1 seconds, to make a pidfile check every sec */
-	initng_handler_set_alarm(s, 1);
+	/* Set the alarm, to make a pidfile check every PID_POLL ms */
+	initng_handler_set_alarm_ms(s, PID_POLL);
 }
 
 /*
@@ -940,8 +946,8 @@ static void timeout_DAEMON_WAIT_FOR_PID_FILE(active_db_h * s)
 	 * NOW, start check for a pid
 	 */
 	if (!try_get_pid(s)) {
-		/* try again in 1 second */
-		initng_handler_set_alarm(s, 1);
+		/* try again in PID_POLL ms */
+		initng_handler_set_alarm_ms(s, PID_POLL);
 	}
 }
 
@@ -1460,7 +1466,7 @@ static int try_get_pid(active_db_h * s)
 		/* finally set the new pid - but not if forks=no, because
 		   that can cause problems */
 		if (is(&FORKS, s))
-			p->pid = pid;
+			initng_process_db_set_pid(p, s, pid);
 
 		/* check with up_check */
 		if (initng_depend_up_check(s) == FAIL) {
@@ -95,34 +95,6 @@ static void w_handler(s_event * event)
 				close(current->fdw.fds);
 			break;
 
-		case IOW_ACTION_CHECK:
-			if (current->fdw.fds <= 2)
-				break;
-
-			/* This is a expensive test, but better safe then
-			 * sorry */
-			if (!STILL_OPEN(current->fdw.fds)) {
-				D_("%i is not open anymore.\n",
-				   current->fdw.fds);
-				current->fdw.fds = -1;
-				break;
-			}
-
-			FD_SET(current->fdw.fds, data->readset);
-			data->added++;
-			break;
-
-		case IOW_ACTION_CALL:
-			if (!data->added || current->fdw.fds <= 2)
-				break;
-
-			if (!FD_ISSET(current->fdw.fds, data->readset))
-				break;
-
-			current->fdw.call_module(&current->fdw, IOW_READ);
-			data->added--;
-			break;
-
 		case IOW_ACTION_DEBUG:
 			if (!data->debug_find_what ||
 			    strstr(__FILE__, data->debug_find_what)) {
@@ -152,12 +124,23 @@ static dbus_bool_t add_dbus_watch(DBusWatch * watch, void *data)
 		return FALSE;
 	}
 
-	w->fdw.fds = dbus_watch_get_unix_fd(watch);
+	w->fdw.fds = -1;
 	w->fdw.call_module = iow_callback;
 	w->dbus = watch;
 	w->fdw.what = 0;
 
 	dbus_watch_set_data(watch, w, free_dbus_watch_data);
+
+	/*
+	 * DBus can have one watch for reading and one for writing on the
+	 * same fd, a dup gives each of them an own entry in the poll set.
+	 */
+	w->fdw.fds = dup(dbus_watch_get_unix_fd(watch));
+	if (w->fdw.fds < 0) {
+		printf("Could not dup dbus fd\n");
+		return FALSE;
+	}
+	initng_io_set_cloexec(w->fdw.fds);
 	toggled_dbus_watch(watch, data);	/* to set initial state */
 
 	initng_list_add(&w->list, &dbus_watches.list);
@@ -167,28 +150,43 @@ static dbus_bool_t add_dbus_watch(DBusWatch * watch, void *data)
 
 static void rem_dbus_watch(DBusWatch * watch, void *data)
 {
-	/*   initng_dbus_watch *w = dbus_watch_get_data(watch);
+	initng_dbus_watch *w = dbus_watch_get_data(watch);
 
-	   if(w) free_dbus_watch_data(w); */
+	/* the struct itself is freed by free_dbus_watch_data() */
+	if (!w || w->fdw.fds < 0)
+		return;
+
+	initng_io_fd_unregister(&w->fdw);
+	close(w->fdw.fds);
+	w->fdw.fds = -1;
+	initng_list_del(&w->list);
 }
 
 static void toggled_dbus_watch(DBusWatch * watch, void *data)
 {
 	initng_dbus_watch *w = dbus_watch_get_data(watch);
+	int flags;
+
+	/*
+	 * A disabled watch is taken out of the poll set, epoll reports a
+	 * hangup or error on it even with no events asked for.
+	 */
+	if (!dbus_watch_get_enabled(watch)) {
+		initng_io_fd_unregister(&w->fdw);
+		return;
+	}
 
-	w->fdw.what = 0;
-	if (dbus_watch_get_enabled(watch)) {
-		int flags = dbus_watch_get_flags(watch);
-
-		if (flags & DBUS_WATCH_READABLE)
-			w->fdw.what |= IOW_READ;
+	flags = dbus_watch_get_flags(watch);
+	w->fdw.what = IOW_ERROR;
 
-		if (flags & DBUS_WATCH_WRITABLE)
-			w->fdw.what |= IOW_WRITE;
+	if (flags & DBUS_WATCH_READABLE)
+		w->fdw.what |= IOW_READ;
 
-		w->fdw.what |= IOW_ERROR;
-	}
+	if (flags & DBUS_WATCH_WRITABLE)
+		w->fdw.what |= IOW_WRITE;
 
+	/* updates it if it is in the poll set already */
+	initng_io_fd_register(&w->fdw);
 }
 
 static void free_dbus_watch_data(void *data)
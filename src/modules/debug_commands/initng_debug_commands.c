@@ -37,6 +37,7 @@
 #include "print_service.h"
 
 static char *cmd_print_fds(char *arg);
+static char *cmd_memory_stats(char *arg);
 static int cmd_initng_quit(char *arg);
 
 #ifdef DEBUG
@@ -76,6 +77,16 @@ s_command QUIT_INITNG = {
 	.description = "Quits initng"
 };
 
+s_command MEMORY_STATS = {
+	.id = 'M',
+	.long_id = "memory_stats",
+	.com_type = STRING_COMMAND,
+	.opt_visible = ADVANCHED_COMMAND,
+	.opt_type = NO_OPT,
+	.u = {(void *)&cmd_memory_stats},
+	.description = "Print allocation statistics of the record caches."
+};
+
 s_command PRINT_ACTIVE_DB = {
 	.id = 'p',
 	.long_id = "print_active_db",
@@ -120,6 +131,11 @@ s_command DEL_VERBOSE = {
 };
 #endif
 
+static char *cmd_memory_stats(char *arg)
+{
+	return initng_slab_stats();
+}
+
 static char *cmd_print_fds(char *arg)
 {
 	char *string = NULL;
@@ -239,6 +255,7 @@ static int cmd_del_verbose(char *arg)
 int module_init(void)
 {
 	initng_command_register(&LIST_FDS);
+	initng_command_register(&MEMORY_STATS);
 	initng_command_register(&PRINT_ACTIVE_DB);
 
 #ifdef DEBUG
@@ -253,6 +270,7 @@ int module_init(void)
 void module_unload(void)
 {
 	initng_command_unregister(&LIST_FDS);
+	initng_command_unregister(&MEMORY_STATS);
 	initng_command_unregister(&PRINT_ACTIVE_DB);
 #ifdef DEBUG
 	initng_command_unregister(&TOGGLE_VERBOSE);
@@ -56,6 +56,17 @@ const struct initng_module initng_module = {
 /* static functions */
 static void initng_reload(void);
 static void filemon_event(f_module_h * from, e_fdw what);
+static int cmd_watched(void *data);
+
+s_command SERVICE_FILES_WATCHED = {
+	.id = 'W',
+	.long_id = "service_files_watched",
+	.com_type = INT_COMMAND,
+	.opt_visible = HIDDEN_COMMAND,
+	.opt_type = NO_OPT,
+	.u = {(void *)&cmd_watched},
+	.description = "Tell if changes to the service files are watched"
+};
 
 /* this module file descriptor we add to monitor */
 f_module_h fdh = {
@@ -69,6 +80,18 @@ int modules_watch = -1;
 int initng_watch = -1;
 int i_watch = -1;
 
+/* the dirs of service files watched, to know the path of a change */
+typedef struct {
+	int wd;
+	char *dir;
+} s_dir_watch;
+
+static s_dir_watch *dirs = NULL;
+static int dirs_len = 0;
+
+#define DIR_EVENTS (IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVE | \
+		    IN_CREATE | IN_DELETE)
+
 static void fdh_handler(s_event * event)
 {
 	s_event_io_watcher_data *data;
@@ -84,32 +107,6 @@ static void fdh_handler(s_event * event)
 			close(fdh.fds);
 		break;
 
-	case IOW_ACTION_CHECK:
-		if (fdh.fds <= 2)
-			break;
-
-		/* This is a expensive test, but better safe then sorry */
-		if (!STILL_OPEN(fdh.fds)) {
-			D_("%i is not open anymore.\n", fdh.fds);
-			fdh.fds = -1;
-			break;
-		}
-
-		FD_SET(fdh.fds, data->readset);
-		data->added++;
-		break;
-
-	case IOW_ACTION_CALL:
-		if (!data->added || fdh.fds <= 2)
-			break;
-
-		if (!FD_ISSET(fdh.fds, data->readset))
-			break;
-
-		filemon_event(&fdh, IOW_READ);
-		data->added--;
-		break;
-
 	case IOW_ACTION_DEBUG:
 		if (!data->debug_find_what ||
 		    strstr(__FILE__, data->debug_find_what)) {
@@ -132,6 +129,55 @@ static void initng_reload(void)
 	}
 }
 
+/* This tells service_file to forget what it knows of a file, NULL for all */
+static void forget_service_file(char *file)
+{
+	s_command *forget = initng_command_find_by_command_string(
+						(char *)"forget_service_file");
+
+	if (forget && forget->u.int_command_call)
+		(*forget->u.int_command_call)(file);
+}
+
+static const char *watched_dir(int wd)
+{
+	int i;
+
+	for (i = 0; i < dirs_len; i++) {
+		if (dirs[i].wd == wd)
+			return dirs[i].dir;
+	}
+
+	return NULL;
+}
+
+static void mon_dir(const char *dir);
+
+/* service_file asks, it only trusts what it has found while watched */
+static int cmd_watched(void *data)
+{
+	(void)data;
+
+	return dirs_len > 0 && strcmp(dirs[0].dir, INITNG_ROOT) == 0;
+}
+
+/* a service file, or dir of them, changed */
+static void service_file_event(struct inotify_event *event, const char *dir)
+{
+	char *file = NULL;
+
+	initng_string_mprintf(&file, "%s/%s", dir, event->name);
+
+	if ((event->mask & IN_ISDIR) &&
+	    (event->mask & (IN_CREATE | IN_MOVED_TO)))
+		mon_dir(file);
+
+	D_("Service file %s changed.\n", file);
+	forget_service_file(file);
+
+	free(file);
+}
+
 /* called by fd hook, when there is data */
 void filemon_event(f_module_h * from, e_fdw what)
 {
@@ -164,6 +210,17 @@ void filemon_event(f_module_h * from, e_fdw what)
 		   if(event->len)
 		   printf("name: %s\n", event->name); */
 
+		/* events were lost, anything may have changed */
+		if (event->mask & IN_Q_OVERFLOW)
+			forget_service_file(NULL);
+
+		if (event->len && (event->mask & DIR_EVENTS)) {
+			const char *dir = watched_dir(event->wd);
+
+			if (dir)
+				service_file_event(event, dir);
+		}
+
 		if (event->mask & IN_MODIFY) {
 			/* check if its a module modified */
 			if (event->wd == modules_watch && event->len &&
@@ -199,24 +256,34 @@ void filemon_event(f_module_h * from, e_fdw what)
 	}
 }
 
-#ifdef FIXME_UNUSED
-static int mon_dir(const char *dir)
+/* watch dir, and all dirs in it, for changed service files */
+static void mon_dir(const char *dir)
 {
 	DIR *path;
 	struct dirent *dir_e;
 	struct stat fstat;
-	char file[256];
+	char *file;
+	int wd;
 
 	/*printf("add watch: %s\n", dir); */
 
-	/* monitor /etc/initng */
-	if (inotify_add_watch(fdh.fds, dir, IN_MODIFY) < 0) {
+	wd = inotify_add_watch(fdh.fds, dir, DIR_EVENTS);
+	if (wd < 0) {
 		F_("Fail to monitor \"%s\"\n", dir);
-		return FALSE;
+		return;
+	}
+
+	/* a dir moved back, is watched already */
+	if (!watched_dir(wd)) {
+		dirs = initng_toolbox_realloc(dirs, (dirs_len + 1) *
+					      sizeof(s_dir_watch));
+		dirs[dirs_len].wd = wd;
+		dirs[dirs_len].dir = initng_toolbox_strdup(dir);
+		dirs_len++;
 	}
 
 	if (!(path = opendir(dir)))
-		return FALSE;
+		return;
 
 	/* Walk thru all files in dir */
 	while ((dir_e = readdir(path))) {
@@ -225,29 +292,18 @@ static int mon_dir(const char *dir)
 			continue;
 
 		/* set up full path */
-		strncpy(file, dir, 40);
-		strcat(file, "/");
-		strcat(file, dir_e->d_name);
-
-		/* get the stat of that file */
-		if (stat(file, &fstat) != 0) {
-			printf("File %s failed stat errno: %s\n", file,
-			       strerror(errno));
-			continue;
-		}
+		file = NULL;
+		initng_string_mprintf(&file, "%s/%s", dir, dir_e->d_name);
 
 		/* if it is a dir */
-		if (S_ISDIR(fstat.st_mode)) {
+		if (stat(file, &fstat) == 0 && S_ISDIR(fstat.st_mode))
 			mon_dir(file);
-			/* continue while loop */
-			continue;
-		}
+
+		free(file);
 	}
 
 	closedir(path);
-	return FALSE;
 }
-#endif /* FIXME_UNUSED */
 
 int module_init(void)
 {
@@ -282,7 +338,12 @@ int module_init(void)
 		return FALSE;
 	}
 
-	/* add this hook */
+	/* monitor the service files */
+	mon_dir(INITNG_ROOT);
+	initng_command_register(&SERVICE_FILES_WATCHED);
+
+	/* poll the inotify fd, and add this hook */
+	initng_io_fd_register(&fdh);
 	initng_event_hook_register(&EVENT_IO_WATCHER, &fdh_handler);
 
 	/* printf("Now monitoring...\n"); */
@@ -291,11 +352,22 @@ int module_init(void)
 
 void module_unload(void)
 {
+	initng_command_unregister(&SERVICE_FILES_WATCHED);
+
 	/* remove watchers */
 	inotify_rm_watch(fdh.fds, modules_watch);
 	inotify_rm_watch(fdh.fds, initng_watch);
 
-	/* close sockets */
+	while (dirs_len > 0) {
+		dirs_len--;
+		inotify_rm_watch(fdh.fds, dirs[dirs_len].wd);
+		free(dirs[dirs_len].dir);
+	}
+	free(dirs);
+	dirs = NULL;
+
+	/* stop polling, and close sockets */
+	initng_io_fd_unregister(&fdh);
 	close(fdh.fds);
 
 	/* remove hooks */
@@ -0,0 +1,430 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "initng_history.h"
+
+/*
+ * Boot critical path, from the state changes in history_db and the
+ * dependency graph.
+ *
+ * For every service that came up, the last start is split in the time
+ * spent waiting for its deps (from the first starting state to leaving
+ * its last *WAITING_FOR_*DEP* state) and the time spent starting (from
+ * there to up).
+ * The critical path is walked back from the last service up, each step
+ * to the dep that came up last. Slack is how much later a service could
+ * have come up without delaying the last one.
+ */
+
+typedef struct {
+	active_db_h *service;
+	double mark;		/* first starting state */
+	double met;		/* start deps met */
+	double up;		/* came up */
+	double latest;		/* latest up, that delays nothing */
+	int in_progress;	/* a start is recorded, but not up yet */
+	int waiting;		/* in a state waiting for deps */
+	int on_path;
+	int done;
+} s_timing;
+
+static double seconds(struct timeval *tv)
+{
+	return tv->tv_sec + tv->tv_usec / 1000000.0;
+}
+
+/*
+ * The timings, indexed on the service pointer. History rows may point
+ * at freed services, so the pointer is only hashed, never followed.
+ */
+static s_timing **by_service = NULL;
+static unsigned int by_service_mask = 0;
+
+static unsigned int slot(active_db_h * service)
+{
+	return ((uintptr_t) service / sizeof(void *)) * 2654435761U &
+	    by_service_mask;
+}
+
+static void index_timings(s_timing * t, int len)
+{
+	unsigned int i;
+	int j;
+
+	by_service_mask = 63;
+	while (by_service_mask < (unsigned int)len * 2)
+		by_service_mask = by_service_mask * 2 + 1;
+
+	by_service = initng_toolbox_calloc(by_service_mask + 1,
+					   sizeof(s_timing *));
+
+	for (j = 0; j < len; j++) {
+		i = slot(t[j].service);
+		while (by_service[i])
+			i = (i + 1) & by_service_mask;
+		by_service[i] = &t[j];
+	}
+}
+
+static s_timing *find(active_db_h * service)
+{
+	unsigned int i;
+
+	for (i = slot(service); by_service[i]; i = (i + 1) & by_service_mask) {
+		if (by_service[i]->service == service)
+			return by_service[i];
+	}
+
+	return NULL;
+}
+
+/* a starting state waiting for deps, like *_WAITING_FOR_START_DEP */
+int history_waiting_for_deps(a_state_h * state)
+{
+	return state->is == IS_STARTING && strstr(state->name, "WAITING_FOR") &&
+	    strstr(state->name, "DEP");
+}
+
+/* collect the timings of the last start of every service still here */
+static int collect(s_timing ** tp)
+{
+	history_h *current = NULL;
+	active_db_h *service = NULL;
+	s_timing *t = NULL;
+	s_timing *s;
+	int len = 0;
+	int size = 0;
+
+	/*
+	 * Only services in active_db are looked at, history_db may hold
+	 * pointers to services freed since.
+	 */
+	while_active_db(service) {
+		if (len == size) {
+			size = size ? size * 2 : 64;
+			t = initng_toolbox_realloc(t, size * sizeof(s_timing));
+		}
+		memset(&t[len], 0, sizeof(s_timing));
+		t[len++].service = service;
+	}
+
+	index_timings(t, len);
+
+	/* oldest first */
+	while_history_db_prev(current) {
+		if (!current->action || !current->service)
+			continue;
+
+		if (!(s = find(current->service)))
+			continue;
+
+		switch (current->action->is) {
+		case IS_STARTING:
+			/* a new start */
+			if (!s->in_progress) {
+				s->mark = seconds(&current->time);
+				s->met = 0;
+				s->up = 0;
+				s->waiting = FALSE;
+				s->in_progress = TRUE;
+			}
+
+			/* deps are met when it leaves the waiting state */
+			if (history_waiting_for_deps(current->action)) {
+				s->waiting = TRUE;
+			} else if (s->waiting) {
+				s->met = seconds(&current->time);
+				s->waiting = FALSE;
+			}
+			break;
+
+		case IS_UP:
+			if (s->in_progress) {
+				s->up = seconds(&current->time);
+				if (!s->met)
+					s->met = s->mark;
+			}
+			s->in_progress = FALSE;
+			break;
+
+		default:
+			s->in_progress = FALSE;
+			break;
+		}
+	}
+
+	*tp = t;
+	return len;
+}
+
+/*
+ * The latest a service could have come up without delaying anything,
+ * that is the earliest of what its dependents could start at.
+ */
+static double latest_up(s_timing * s, double end)
+{
+	s_timing *d;
+	s_dep *edge;
+	double latest = end;
+	int i;
+
+	if (s->done)
+		return s->latest;
+
+	/* guards against circular deps */
+	s->done = TRUE;
+	s->latest = end;
+
+	while_depend_redges(i, edge, s->service) {
+		if (!DEP_IS_DEPEND(edge))
+			continue;
+
+		d = find(edge->from);
+		if (!d || !d->up || d == s)
+			continue;
+
+		/* d could have started its deps met time this much later */
+		if (latest_up(d, end) - (d->up - d->met) < latest)
+			latest = d->latest - (d->up - d->met);
+	}
+
+	s->latest = latest;
+	return latest;
+}
+
+/* the dep of s that came up last, before s had its deps met */
+static s_timing *critical_dep(s_timing * s)
+{
+	s_timing *best = NULL;
+	s_timing *d;
+	s_dep *edge;
+
+	while_depend_edges(edge, s->service) {
+		if (!DEP_IS_DEPEND(edge) || !edge->to)
+			continue;
+
+		d = find(edge->to);
+		if (!d || !d->up || d->on_path || d->up > s->met)
+			continue;
+
+		if (!best || d->up > best->up)
+			best = d;
+	}
+
+	return best;
+}
+
+static void json_name(char **string, const char *name)
+{
+	initng_string_mprintf(string, "\"");
+	for (; *name; name++) {
+		if (*name == '"' || *name == '\\')
+			initng_string_mprintf(string, "\\%c", *name);
+		else
+			initng_string_mprintf(string, "%c", *name);
+	}
+	initng_string_mprintf(string, "\"");
+}
+
+static void print_text(char **string, s_timing * t, int len,
+		       s_timing ** path, int path_len, double begin)
+{
+	int i;
+
+	initng_string_mprintf(string, "Critical path, %.3f seconds:\n",
+			      path_len ? path[0]->up - begin : 0.0);
+	initng_string_mprintf(string, " %-30s %9s %9s %9s\n", "SERVICE",
+			      "UP AT", "WAITING", "STARTING");
+
+	for (i = path_len - 1; i >= 0; i--) {
+		initng_string_mprintf(string, " %-30s %9.3f %9.3f %9.3f\n",
+				      path[i]->service->name,
+				      path[i]->up - begin,
+				      path[i]->met - path[i]->mark,
+				      path[i]->up - path[i]->met);
+	}
+
+	initng_string_mprintf(string, "\nAll services:\n");
+	initng_string_mprintf(string, " %-30s %9s %9s %9s %9s\n", "SERVICE",
+			      "UP AT", "WAITING", "STARTING", "SLACK");
+
+	for (i = 0; i < len; i++) {
+		if (!t[i].up)
+			continue;
+
+		initng_string_mprintf(string, " %-30s %9.3f %9.3f %9.3f %9.3f\n",
+				      t[i].service->name, t[i].up - begin,
+				      t[i].met - t[i].mark, t[i].up - t[i].met,
+				      t[i].latest - t[i].up);
+	}
+}
+
+static void print_dot(char **string, s_timing * t, int len)
+{
+	s_dep *edge;
+	s_timing *d;
+	int i;
+
+	initng_string_mprintf(string, "digraph boot {\n");
+	initng_string_mprintf(string, "\trankdir=LR;\n");
+
+	for (i = 0; i < len; i++) {
+		if (!t[i].up)
+			continue;
+
+		initng_string_mprintf(string, "\t\"%s\" [label=\"%s\\n%.3fs\"%s];\n",
+				      t[i].service->name, t[i].service->name,
+				      t[i].up - t[i].met,
+				      t[i].on_path ? " color=red" : "");
+
+		while_depend_edges(edge, t[i].service) {
+			if (!DEP_IS_DEPEND(edge) || !edge->to)
+				continue;
+
+			d = find(edge->to);
+			if (!d || !d->up)
+				continue;
+
+			initng_string_mprintf(string, "\t\"%s\" -> \"%s\"%s;\n",
+					      d->service->name,
+					      t[i].service->name,
+					      d->on_path && t[i].on_path ?
+					      " [color=red]" : "");
+		}
+	}
+
+	initng_string_mprintf(string, "}\n");
+}
+
+static void print_json(char **string, s_timing * t, int len,
+		       s_timing ** path, int path_len, double begin)
+{
+	s_dep *edge;
+	int first = TRUE;
+	int i;
+
+	initng_string_mprintf(string, "{\"services\":[");
+
+	for (i = 0; i < len; i++) {
+		int first_dep = TRUE;
+
+		if (!t[i].up)
+			continue;
+
+		initng_string_mprintf(string, "%s{\"name\":", first ? "" : ",");
+		json_name(string, t[i].service->name);
+		initng_string_mprintf(string, ",\"up_at\":%.3f,\"waiting\":%.3f,"
+				      "\"starting\":%.3f,\"slack\":%.3f,"
+				      "\"deps\":[", t[i].up - begin,
+				      t[i].met - t[i].mark, t[i].up - t[i].met,
+				      t[i].latest - t[i].up);
+
+		while_depend_edges(edge, t[i].service) {
+			if (!DEP_IS_DEPEND(edge))
+				continue;
+
+			if (!first_dep)
+				initng_string_mprintf(string, ",");
+			json_name(string, edge->name);
+			first_dep = FALSE;
+		}
+
+		initng_string_mprintf(string, "]}");
+		first = FALSE;
+	}
+
+	initng_string_mprintf(string, "],\"critical_path\":[");
+
+	for (i = path_len - 1; i >= 0; i--) {
+		json_name(string, path[i]->service->name);
+		if (i)
+			initng_string_mprintf(string, ",");
+	}
+
+	initng_string_mprintf(string, "]}\n");
+}
+
+/*
+ * ngc command, arg "dot" or "json" selects the export format.
+ */
+char *history_critical_path(char *arg)
+{
+	char *string = NULL;
+	s_timing *t = NULL;
+	s_timing **path = NULL;
+	s_timing *last = NULL;
+	s_timing *s;
+	double begin = 0;
+	int path_len = 0;
+	int len;
+	int i;
+
+	initng_depend_graph_sync();
+
+	len = collect(&t);
+
+	for (i = 0; i < len; i++) {
+		if (!t[i].up)
+			continue;
+		if (!begin || t[i].mark < begin)
+			begin = t[i].mark;
+		if (!last || t[i].up > last->up)
+			last = &t[i];
+	}
+
+	if (!last) {
+		free(t);
+		free(by_service);
+		by_service = NULL;
+		return initng_toolbox_strdup("No service start recorded.\n");
+	}
+
+	for (i = 0; i < len; i++) {
+		if (t[i].up)
+			latest_up(&t[i], last->up);
+	}
+
+	/* walk back from the last service up */
+	path = initng_toolbox_calloc(len, sizeof(s_timing *));
+	for (s = last; s; s = critical_dep(s)) {
+		s->on_path = TRUE;
+		path[path_len++] = s;
+	}
+
+	if (arg && strcmp(arg, "dot") == 0)
+		print_dot(&string, t, len);
+	else if (arg && strcmp(arg, "json") == 0)
+		print_json(&string, t, len, path, path_len, begin);
+	else
+		print_text(&string, t, len, path, path_len, begin);
+
+	free(path);
+	free(t);
+	free(by_service);
+	by_service = NULL;
+	return string;
+}
@@ -260,6 +260,17 @@ s_command LOG = {
 	.description = "Print out log."
 };
 
+s_command CRITICAL_PATH = {
+	.id = 'P',
+	.long_id = "critical_path",
+	.com_type = STRING_COMMAND,
+	.opt_visible = ADVANCHED_COMMAND,
+	.opt_type = USES_OPT,
+	.u = {(void *)&history_critical_path},
+	.description = "Print the boot critical path, \"dot\" or \"json\" "
+	    "as option exports it."
+};
+
 static void history_db_compensate_time(s_event * event)
 {
 	time_t *skew;
@@ -446,10 +457,12 @@ int module_init(void)
 
 	initng_command_register(&HISTORYS);
 	initng_command_register(&LOG);
+	initng_command_register(&CRITICAL_PATH);
 	initng_event_hook_register(&EVENT_STATE_CHANGE, &history_add_values);
 	initng_event_hook_register(&EVENT_COMPENSATE_TIME,
 				   &history_db_compensate_time);
 	initng_event_hook_register(&EVENT_BUFFER_WATCHER, &fetch_output);
+	history_start_times_init();
 
 	return TRUE;
 }
@@ -458,9 +471,11 @@ void module_unload(void)
 {
 	initng_command_unregister(&HISTORYS);
 	initng_command_unregister(&LOG);
+	initng_command_unregister(&CRITICAL_PATH);
 	history_free_all();
 	initng_event_hook_unregister(&EVENT_STATE_CHANGE, &history_add_values);
 	initng_event_hook_unregister(&EVENT_COMPENSATE_TIME,
 				     &history_db_compensate_time);
 	initng_event_hook_unregister(&EVENT_BUFFER_WATCHER, &fetch_output);
+	history_start_times_unload();
 }
@@ -42,6 +42,14 @@ struct history_s {
 
 extern history_h history_db;
 
+/* the ngc critical_path command, in critical_path.c */
+char *history_critical_path(char *arg);
+int history_waiting_for_deps(a_state_h * state);
+
+/* start durations kept across boots, in start_times.c */
+void history_start_times_init(void);
+void history_start_times_unload(void);
+
 #define while_history_db(current) \
 	initng_list_foreach(current, &history_db.list, list)
 
@@ -0,0 +1,320 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <assert.h>
+
+#include "initng_history.h"
+
+/*
+ * Start durations, kept across boots.
+ *
+ * The time from leaving the state waiting for deps to up is measured for
+ * every service, and saved when the system is up. Services marked for
+ * start are ranked by how long the chain of starts still waiting for
+ * them takes, so a module limiting starts, like jobslots, can let the
+ * heads of the longest chains in first.
+ */
+
+#define TIMES_FILE	VARDIR "/initng_start_times.v1"
+#define TIMES_MAGIC	"INST"
+#define TIMES_NAME_LEN	100
+#define TIMES_BUCKETS	64
+
+typedef struct {
+	char magic[4];
+	uint32_t count;
+} s_times_header;
+
+typedef struct {
+	char name[TIMES_NAME_LEN + 1];
+	uint32_t ms;
+} s_times_entry;
+
+typedef struct s_start_time_s {
+	char *name;
+	hash_t hash;
+	int ms;			/* smoothed start duration */
+	struct timeval met;	/* when its deps were met this start */
+	list_t list;
+} s_start_time;
+
+static list_t times[TIMES_BUCKETS];
+
+static s_start_time *find(const char *name, int add)
+{
+	s_start_time *current;
+	hash_t hash = initng_hash_str(name);
+	list_t *head = &times[hash % TIMES_BUCKETS];
+
+	initng_list_foreach(current, head, list) {
+		if (current->hash == hash && strcmp(current->name, name) == 0)
+			return current;
+	}
+
+	if (!add)
+		return NULL;
+
+	current = initng_toolbox_calloc(1, sizeof(s_start_time));
+	current->name = initng_toolbox_strdup(name);
+	current->hash = hash;
+	current->ms = -1;
+	initng_list_add(&current->list, head);
+
+	return current;
+}
+
+static void read_times(void)
+{
+	s_times_header header;
+	s_times_entry entry;
+	FILE *fil;
+	uint32_t i;
+
+	if (!(fil = fopen(TIMES_FILE, "r")))
+		return;
+
+	if (fread(&header, sizeof(header), 1, fil) != 1 ||
+	    memcmp(header.magic, TIMES_MAGIC, 4) != 0) {
+		F_("%s is not a start times file.\n", TIMES_FILE);
+		fclose(fil);
+		return;
+	}
+
+	for (i = 0; i < header.count; i++) {
+		if (fread(&entry, sizeof(entry), 1, fil) != 1)
+			break;
+
+		entry.name[TIMES_NAME_LEN] = '\0';
+		find(entry.name, TRUE)->ms = entry.ms;
+	}
+
+	D_("Read %i start times.\n", (int)i);
+	fclose(fil);
+}
+
+static void write_times(void)
+{
+	s_times_header header;
+	s_times_entry entry;
+	s_start_time *current;
+	FILE *fil;
+	int i;
+
+	if (!(fil = fopen(TIMES_FILE ".tmp", "w"))) {
+		F_("Could not write %s: %m\n", TIMES_FILE);
+		return;
+	}
+
+	memcpy(header.magic, TIMES_MAGIC, 4);
+	header.count = 0;
+	for (i = 0; i < TIMES_BUCKETS; i++) {
+		initng_list_foreach(current, &times[i], list) {
+			if (current->ms >= 0)
+				header.count++;
+		}
+	}
+
+	if (fwrite(&header, sizeof(header), 1, fil) != 1)
+		goto fail;
+
+	for (i = 0; i < TIMES_BUCKETS; i++) {
+		initng_list_foreach(current, &times[i], list) {
+			if (current->ms < 0)
+				continue;
+
+			memset(&entry, 0, sizeof(entry));
+			strncpy(entry.name, current->name, TIMES_NAME_LEN);
+			entry.ms = current->ms;
+			if (fwrite(&entry, sizeof(entry), 1, fil) != 1)
+				goto fail;
+		}
+	}
+
+	fclose(fil);
+	rename(TIMES_FILE ".tmp", TIMES_FILE);
+	return;
+
+fail:
+	F_("Could not write %s: %m\n", TIMES_FILE);
+	fclose(fil);
+	unlink(TIMES_FILE ".tmp");
+}
+
+/* measure the start, from deps met to up */
+static void measure(s_event * event)
+{
+	active_db_h *service;
+	s_start_time *t;
+	int ms;
+
+	assert(event->event_type == &EVENT_STATE_CHANGE);
+	assert(event->data);
+
+	service = event->data;
+
+	/* deps are met when it leaves the state waiting for them */
+	if (GET_STATE(service) == IS_STARTING && service->last_state &&
+	    history_waiting_for_deps(service->last_state) &&
+	    !history_waiting_for_deps(service->current_state)) {
+		t = find(service->name, TRUE);
+		memcpy(&t->met, &service->time_current_state,
+		       sizeof(struct timeval));
+		return;
+	}
+
+	if (GET_STATE(service) != IS_UP)
+		return;
+
+	if (!(t = find(service->name, FALSE)) || !t->met.tv_sec)
+		return;
+
+	ms = (service->time_current_state.tv_sec - t->met.tv_sec) * 1000 +
+	    (service->time_current_state.tv_usec - t->met.tv_usec) / 1000;
+	t->met.tv_sec = 0;
+	if (ms < 0)
+		return;
+
+	/* smooth it, one slow boot should not turn the order around */
+	t->ms = t->ms < 0 ? ms : (t->ms * 3 + ms) / 4;
+}
+
+/* the smoothed start time of service, 0 if not known yet */
+static int own_ms(active_db_h * service)
+{
+	s_start_time *t = find(service->name, FALSE);
+
+	return t && t->ms > 0 ? t->ms : 0;
+}
+
+/*
+ * Raise the rank of the starting services service depends on, to their
+ * own start time plus the rank of service, and on down their deps. A
+ * path has no more services than are starting, a circle would never
+ * stop rising.
+ */
+static void push_down(active_db_h * service, int depth)
+{
+	s_dep *edge;
+	int r;
+
+	if (depth > g.active_db_is[IS_STARTING])
+		return;
+
+	while_depend_edges(edge, service) {
+		if (!DEP_IS_DEPEND(edge) || !edge->to || edge->to == service ||
+		    GET_STATE(edge->to) != IS_STARTING)
+			continue;
+
+		r = service->start_rank + own_ms(edge->to);
+		if (r <= edge->to->start_rank)
+			continue;
+
+		edge->to->start_rank = r;
+		push_down(edge->to, depth + 1);
+	}
+}
+
+/*
+ * A service marked for start is ranked by its own start time, plus the
+ * longest rank of the starting services that depend on it. They are
+ * not all marked before their deps, so the rank is pushed down to the
+ * deps marked already, and every rank ends up the longest chain of
+ * starts waiting for it, whatever order they were marked in.
+ */
+static void rank(s_event * event)
+{
+	active_db_h *service;
+	s_dep *edge;
+	int longest = 0;
+	int i;
+
+	assert(event->event_type == &EVENT_IS_CHANGE);
+	assert(event->data);
+
+	service = event->data;
+
+	if (GET_STATE(service) != IS_STARTING)
+		return;
+
+	initng_depend_graph_sync();
+
+	while_depend_redges(i, edge, service) {
+		if (DEP_IS_DEPEND(edge) && edge->from != service &&
+		    GET_STATE(edge->from) == IS_STARTING &&
+		    edge->from->start_rank > longest)
+			longest = edge->from->start_rank;
+	}
+
+	service->start_rank = longest + own_ms(service);
+	push_down(service, 0);
+
+	D_("%s has start rank %i.\n", service->name, service->start_rank);
+}
+
+static void save_times(s_event * event)
+{
+	h_sys_state *state;
+
+	assert(event->event_type == &EVENT_SYSTEM_CHANGE);
+	assert(event->data);
+
+	state = event->data;
+
+	if (*state == STATE_UP)
+		write_times();
+}
+
+void history_start_times_init(void)
+{
+	int i;
+
+	for (i = 0; i < TIMES_BUCKETS; i++)
+		initng_list_init(&times[i]);
+
+	read_times();
+
+	initng_event_hook_register(&EVENT_STATE_CHANGE, &measure);
+	initng_event_hook_register(&EVENT_IS_CHANGE, &rank);
+	initng_event_hook_register(&EVENT_SYSTEM_CHANGE, &save_times);
+}
+
+void history_start_times_unload(void)
+{
+	s_start_time *current, *safe = NULL;
+	int i;
+
+	initng_event_hook_unregister(&EVENT_STATE_CHANGE, &measure);
+	initng_event_hook_unregister(&EVENT_IS_CHANGE, &rank);
+	initng_event_hook_unregister(&EVENT_SYSTEM_CHANGE, &save_times);
+
+	for (i = 0; i < TIMES_BUCKETS; i++) {
+		initng_list_foreach_safe(current, safe, &times[i], list) {
+			initng_list_del(&current->list);
+			free(current->name);
+			free(current);
+		}
+	}
+}
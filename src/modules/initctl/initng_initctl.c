@@ -84,33 +84,6 @@ static void pipe_io_handler(s_event * event)
 			close(pipe_fd.fds);
 		break;
 
-	case IOW_ACTION_CHECK:
-		if (pipe_fd.fds <= 2)
-			break;
-
-		/* This is a expensive test, but better safe then
-		 * sorry */
-		if (!STILL_OPEN(pipe_fd.fds)) {
-			D_("%i is not open anymore.\n", pipe_fd.fds);
-			pipe_fd.fds = -1;
-			break;
-		}
-
-		FD_SET(pipe_fd.fds, data->readset);
-		data->added++;
-		break;
-
-	case IOW_ACTION_CALL:
-		if (!data->added || pipe_fd.fds <= 2)
-			break;
-
-		if (!FD_ISSET(pipe_fd.fds, data->readset))
-			break;
-
-		parse_control_input(&pipe_fd, IOW_READ);
-		data->added--;
-		break;
-
 	case IOW_ACTION_DEBUG:
 		if (!data->debug_find_what ||
 		    strstr(__FILE__, data->debug_find_what)) {
@@ -125,6 +98,7 @@ static void pipe_io_handler(s_event * event)
 static void initctl_control_close(void)
 {
 	if (pipe_fd.fds > 2) {
+		initng_io_fd_unregister(&pipe_fd);
 		close(pipe_fd.fds);
 		pipe_fd.fds = -1;
 	}
@@ -173,7 +147,8 @@ static int initctl_control_open(void)
 
 		initng_io_set_cloexec(pipe_fd.fds);
 
-		/* ok, finally add hook */
+		/* ok, finally poll it and add hook */
+		initng_io_fd_register(&pipe_fd);
 		initng_event_hook_register(&EVENT_IO_WATCHER, &pipe_io_handler);
 	}
 
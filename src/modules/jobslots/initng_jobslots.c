@@ -0,0 +1,480 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+
+#include <stdio.h>
+#include <stdlib.h>		/* free() exit() */
+#include <string.h>
+#include <stdint.h>		/* uintptr_t */
+#include <unistd.h>		/* sysconf() */
+#include <assert.h>
+
+static int module_init(void);
+static void module_unload(void);
+
+const struct initng_module initng_module = {
+	.api_version = API_VERSION,
+	.deps = { NULL },
+	.init = &module_init,
+	.unload = &module_unload
+};
+
+/* PSI some avg10, in percent, where a resource counts as busy */
+#define PSI_BUSY 40
+
+/* load average per cpu, where cpu counts as busy without PSI */
+#define LOAD_BUSY 2
+
+s_entry JOB_CLASS = {
+	.name = "job_class",
+	.description = "The job class of this service, like io_heavy or "
+	    "cpu_heavy, limited by max_parallel_<class>.",
+	.type = STRING,
+	.ot = NULL,
+};
+
+s_entry START_PRIORITY = {
+	.name = "start_priority",
+	.description = "Services waiting for a job slot are started highest "
+	    "priority first, default 0.",
+	.type = INT,
+	.ot = NULL,
+};
+
+/* a max_parallel_<class>= limit */
+typedef struct s_class_s {
+	char *name;
+	int max;
+	int held;		/* slots held by its services */
+	int kept;		/* and kept for them, see hand_out() */
+	list_t list;
+} s_class;
+
+/* a service holding, or waiting for, a job slot */
+typedef struct s_job_s {
+	active_db_h *service;
+	char *name;
+	s_class *limit;		/* of its job class, if any */
+	int priority;
+	int rank;		/* start_rank, when it asked */
+	int held;		/* on jobs, else on waiters */
+	int reserved;		/* a slot is kept for it */
+	list_t list;
+	list_t hash;		/* in by_service */
+} s_job;
+
+#define JOB_BUCKETS 64
+
+static list_t jobs = LIST_HEAD_INIT(jobs);
+static list_t waiters = LIST_HEAD_INIT(waiters);
+static list_t classes = LIST_HEAD_INIT(classes);
+static list_t by_service[JOB_BUCKETS];
+
+/* 0 is no global limit */
+static int max_parallel = 0;
+
+/* the slots held, and kept for waiters, of all classes */
+static int held = 0;
+static int kept = 0;
+
+/* rechecks the waiters while the limits are lowered by load */
+static s_timer retry;
+
+static int cpu_busy = FALSE;
+static int io_busy = FALSE;
+static time_t last_sample = 0;
+
+static list_t *bucket(active_db_h * service)
+{
+	list_t *head = &by_service[((uintptr_t) service >> 4) % JOB_BUCKETS];
+
+	/* buckets are set up the first time they are used */
+	if (!head->next)
+		initng_list_init(head);
+
+	return head;
+}
+
+/* count job in or out of the slots held, and kept */
+static void slots(s_job * job, int h, int k)
+{
+	held += h;
+	kept += k;
+	if (job->limit) {
+		job->limit->held += h;
+		job->limit->kept += k;
+	}
+}
+
+static void job_free(s_job * job)
+{
+	slots(job, job->held ? -1 : 0, job->reserved ? -1 : 0);
+	initng_list_del(&job->list);
+	initng_list_del(&job->hash);
+	free(job->name);
+	free(job);
+}
+
+/*
+ * Is the service of job gone, or done starting? Services are freed
+ * without any event, so the name is looked up again.
+ */
+static int gone(s_job * job)
+{
+	return initng_active_db_find_by_name(job->name) != job->service ||
+	    GET_STATE(job->service) != IS_STARTING;
+}
+
+static s_job *find(active_db_h * service)
+{
+	s_job *job;
+
+	initng_list_foreach(job, bucket(service), hash) {
+		if (job->service == service &&
+		    strcmp(job->name, service->name) == 0)
+			return job;
+	}
+
+	return NULL;
+}
+
+/* the some avg10 value of /proc/pressure/<what>, -1 if not there */
+static int read_psi(const char *path)
+{
+	FILE *fp;
+	float avg10;
+	int ret = -1;
+
+	if (!(fp = fopen(path, "r")))
+		return -1;
+
+	if (fscanf(fp, "some avg10=%f", &avg10) == 1)
+		ret = (int)avg10;
+
+	fclose(fp);
+	return ret;
+}
+
+static void sample_load(void)
+{
+	FILE *fp;
+	float load = 0;
+	int cpu, io;
+	long cpus;
+
+	/* at most once a second */
+	if (g.now.tv_sec == last_sample)
+		return;
+	last_sample = g.now.tv_sec;
+
+	cpu = read_psi("/proc/pressure/cpu");
+	io = read_psi("/proc/pressure/io");
+
+	if (cpu >= 0) {
+		cpu_busy = (cpu >= PSI_BUSY);
+	} else if ((fp = fopen("/proc/loadavg", "r"))) {
+		if (fscanf(fp, "%f", &load) != 1)
+			load = 0;
+		fclose(fp);
+
+		cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		if (cpus < 1)
+			cpus = 1;
+		cpu_busy = (load > cpus * LOAD_BUSY);
+	}
+
+	io_busy = (io >= PSI_BUSY);
+
+	D_("jobslots: cpu %s, io %s\n", cpu_busy ? "busy" : "idle",
+	   io_busy ? "busy" : "idle");
+}
+
+/* halve a limit while its resource is busy, 0 stays unlimited */
+static int adapt(int max, int busy)
+{
+	if (max > 1 && busy)
+		return max / 2;
+	return max;
+}
+
+/* the limit of class, NULL if it has none */
+static s_class *class_limit(const char *class)
+{
+	s_class *current;
+
+	if (!class)
+		return NULL;
+
+	initng_list_foreach(current, &classes, list) {
+		if (strcmp(current->name, class) == 0)
+			return current->max ? current : NULL;
+	}
+
+	return NULL;
+}
+
+/* are all slots taken, whatever the class */
+static int full(void)
+{
+	int max = adapt(max_parallel, cpu_busy);
+
+	return max && held + kept >= max;
+}
+
+/* is there a free slot for job, besides the ones held and kept */
+static int fits(s_job * job)
+{
+	s_class *limit = job->limit;
+
+	if (full())
+		return FALSE;
+
+	if (limit && limit->held + limit->kept >=
+	    adapt(limit->max, strncmp(limit->name, "io", 2) == 0 ?
+		  io_busy : cpu_busy))
+		return FALSE;
+
+	return TRUE;
+}
+
+/* a waiter not held back by its own deps, it would start if let in */
+static int runnable(s_job * job)
+{
+	return job->service->deps_unmet == 0 && !job->service->deps_cycle;
+}
+
+/*
+ * Does a go before b? Highest start_priority first, and then highest
+ * start_rank, the heads of the longest start chains.
+ */
+static int before(s_job * a, s_job * b)
+{
+	if (a->priority != b->priority)
+		return a->priority > b->priority;
+	return a->rank > b->rank;
+}
+
+/* waiters are kept in the order they go in */
+static void add_waiter(s_job * job)
+{
+	s_job *current;
+
+	initng_list_foreach(current, &waiters, list) {
+		if (before(job, current)) {
+			initng_list_add_tail(&job->list, &current->list);
+			return;
+		}
+	}
+
+	initng_list_add_tail(&job->list, &waiters);
+}
+
+/*
+ * Keep the free slots for the runnable waiters that fit, in order, and
+ * wake them to take them, all but self that is asking already. Only as
+ * many are woken as there are free slots.
+ */
+static void hand_out(s_job * self)
+{
+	s_job *job, *safe = NULL;
+
+	/* there are no more of them than the limits */
+	initng_list_foreach_safe(job, safe, &jobs, list) {
+		if (gone(job))
+			job_free(job);
+	}
+
+	initng_list_foreach_safe(job, safe, &waiters, list) {
+		if (job != self && gone(job)) {
+			job_free(job);
+			continue;
+		}
+
+		if (full())
+			break;
+
+		if (job->reserved || !runnable(job) || !fits(job))
+			continue;
+
+		D_("A job slot is kept for %s.\n", job->name);
+		job->reserved = TRUE;
+		slots(job, 0, 1);
+		if (job != self)
+			initng_interrupt_ready(job->service);
+	}
+}
+
+static void retry_waiters(s_timer * timer)
+{
+	(void)timer;
+
+	sample_load();
+	hand_out(NULL);
+
+	/* the limits may rise more when the load drops */
+	if ((cpu_busy || io_busy) && !initng_list_isempty(&waiters))
+		initng_timer_arm(&retry, 1000);
+}
+
+static void admit(s_event * event)
+{
+	active_db_h *service;
+	s_job *job;
+	s_class *limit;
+
+	assert(event->event_type == &EVENT_START_DEP_MET);
+	assert(event->data);
+
+	service = event->data;
+
+	if (!(job = find(service))) {
+		limit = class_limit(get_string(&JOB_CLASS, service));
+
+		/* nothing to count it against */
+		if (!max_parallel && !limit)
+			return;
+
+		job = initng_toolbox_calloc(1, sizeof(s_job));
+		job->service = service;
+		job->name = initng_toolbox_strdup(service->name);
+		job->limit = limit;
+		job->priority = get_int(&START_PRIORITY, service);
+		job->rank = service->start_rank;
+		initng_list_add(&job->hash, bucket(service));
+		add_waiter(job);
+	}
+
+	/* already holding a slot */
+	if (job->held)
+		return;
+
+	/* a slot kept for it is taken as is, else it asks in turn */
+	if (!job->reserved) {
+		sample_load();
+		hand_out(job);
+	}
+
+	if (!job->reserved)
+		goto wait;
+
+	D_("%s got a job slot.\n", service->name);
+	job->reserved = FALSE;
+	job->held = TRUE;
+	slots(job, 1, -1);
+	initng_list_del(&job->list);
+	initng_list_add(&job->list, &jobs);
+	return;
+
+wait:
+	/* the limits may rise when the load drops */
+	if ((cpu_busy || io_busy) && !initng_timer_is_armed(&retry))
+		initng_timer_arm(&retry, 1000);
+
+	/* hand_out() wakes it, when there is a slot */
+	initng_interrupt_hold(service);
+	event->status = FAILED;
+}
+
+/* give the slot back, and let the next one in */
+static void release(s_event * event)
+{
+	active_db_h *service;
+	s_job *job;
+
+	assert(event->event_type == &EVENT_IS_CHANGE);
+	assert(event->data);
+
+	service = event->data;
+
+	if (GET_STATE(service) == IS_STARTING)
+		return;
+
+	if ((job = find(service))) {
+		job_free(job);
+		hand_out(NULL);
+	}
+}
+
+static void parse_limits(void)
+{
+	const char *arg;
+	s_class *class;
+	int i;
+
+	for (i = 0; g.Argv[i]; i++) {
+		arg = g.Argv[i];
+
+		if (strncmp(arg, "max_parallel_", 13) != 0)
+			continue;
+
+		if (strncmp(arg, "max_parallel_starts=", 20) == 0) {
+			max_parallel = atoi(&arg[20]);
+			continue;
+		}
+
+		/* max_parallel_=N has no class */
+		if (!strchr(arg, '=') || arg[13] == '=') {
+			W_("Ignoring %s, no job class.\n", arg);
+			continue;
+		}
+
+		class = initng_toolbox_calloc(1, sizeof(s_class));
+		class->name = initng_toolbox_strndup(&arg[13],
+						     strchr(arg, '=') - &arg[13]);
+		class->max = atoi(strchr(arg, '=') + 1);
+		initng_list_add(&class->list, &classes);
+	}
+}
+
+int module_init(void)
+{
+	parse_limits();
+	initng_timer_init(&retry, &retry_waiters);
+
+	initng_service_data_type_register(&JOB_CLASS);
+	initng_service_data_type_register(&START_PRIORITY);
+	initng_event_hook_register(&EVENT_START_DEP_MET, &admit);
+	initng_event_hook_register(&EVENT_IS_CHANGE, &release);
+	return TRUE;
+}
+
+void module_unload(void)
+{
+	s_job *job, *safe = NULL;
+	s_class *class, *csafe = NULL;
+
+	initng_event_hook_unregister(&EVENT_START_DEP_MET, &admit);
+	initng_event_hook_unregister(&EVENT_IS_CHANGE, &release);
+	initng_service_data_type_unregister(&JOB_CLASS);
+	initng_service_data_type_unregister(&START_PRIORITY);
+	initng_timer_cancel(&retry);
+
+	initng_list_foreach_safe(job, safe, &jobs, list) {
+		job_free(job);
+	}
+	initng_list_foreach_safe(job, safe, &waiters, list) {
+		job_free(job);
+	}
+	initng_list_foreach_safe(class, csafe, &classes, list) {
+		initng_list_del(&class->list);
+		free(class->name);
+		free(class);
+	}
+}
@@ -230,7 +230,7 @@ static const char *err_desc(void)
 
 /* this function set rlimit if it should, w-o overwriting old values. */
 static int set_limit(s_entry * soft, s_entry * hard, active_db_h * service,
-		     int ltype, int times)
+		     int ltype, int times, s_spawn * plan)
 {
 	int si = FALSE;
 	int sh = FALSE;
@@ -266,23 +266,20 @@ static int set_limit(s_entry * soft, s_entry * hard, active_db_h * service,
 
 	D_("now: soft: %i, hard: %i\n", (int)l.rlim_cur, (int)l.rlim_max);
 
-	/* set the limit and return status */
-	if (setrlimit(ltype, &l) != 0) {
-		F_("setrlimit failed, service: %s, limit type %i: %s\n",
-		   service->name, ltype, err_desc());
+	/* the child sets it */
+	if (!initng_spawn_add_limit(plan, ltype, &l))
 		return -1;
-	}
 
 	return 0;
 }
 
 static void do_limit(s_event * event)
 {
-	s_event_after_fork_data *data;
+	s_event_spawn_plan_data *data;
 
 	int ret = 0;
 
-	assert(event->event_type == &EVENT_AFTER_FORK);
+	assert(event->event_type == &EVENT_SPAWN_PLAN);
 	assert(event->data);
 
 	data = event->data;
@@ -295,50 +292,50 @@ static void do_limit(s_event * event)
 
 	/* Handle RLIMIT_AS */
 	ret += set_limit(&RLIMIT_AS_SOFT, &RLIMIT_AS_HARD, data->service,
-			 RLIMIT_AS, 1024);
+			 RLIMIT_AS, 1024, data->plan);
 
 	/* Handle RLIMIT_CORE */
 	ret += set_limit(&RLIMIT_CORE_SOFT, &RLIMIT_CORE_HARD, data->service,
-			 RLIMIT_CORE, 1024);
+			 RLIMIT_CORE, 1024, data->plan);
 
 	/* Handle RLIMIT_CPU */
 	ret += set_limit(&RLIMIT_CPU_SOFT, &RLIMIT_CPU_HARD, data->service,
-			 RLIMIT_CPU, 1);
+			 RLIMIT_CPU, 1, data->plan);
 
 	/* Handle RLIMIT_DATA */
 	ret += set_limit(&RLIMIT_DATA_SOFT, &RLIMIT_DATA_HARD, data->service,
-			 RLIMIT_DATA, 1024);
+			 RLIMIT_DATA, 1024, data->plan);
 
 	/* Handle RLIMIT_FSIZE */
 	ret += set_limit(&RLIMIT_FSIZE_SOFT, &RLIMIT_FSIZE_HARD,
-			 data->service, RLIMIT_FSIZE, 1024);
+			 data->service, RLIMIT_FSIZE, 1024, data->plan);
 
 	/* Handle RLIMIT_MEMLOCK */
 	ret += set_limit(&RLIMIT_MEMLOCK_SOFT, &RLIMIT_MEMLOCK_HARD,
-			 data->service, RLIMIT_MEMLOCK, 1024);
+			 data->service, RLIMIT_MEMLOCK, 1024, data->plan);
 
 	/* Handle RLIMIT_NOFILE */
 	ret += set_limit(&RLIMIT_NOFILE_SOFT, &RLIMIT_NOFILE_HARD,
-			 data->service, RLIMIT_NOFILE, 1);
+			 data->service, RLIMIT_NOFILE, 1, data->plan);
 
 	/* Handle RLIMIT_NPROC */
 	ret += set_limit(&RLIMIT_NPROC_SOFT, &RLIMIT_NPROC_HARD,
-			 data->service, RLIMIT_NPROC, 1);
+			 data->service, RLIMIT_NPROC, 1, data->plan);
 
 	/* Handle RLIMIT_RSS */
 	ret += set_limit(&RLIMIT_RSS_SOFT, &RLIMIT_RSS_HARD, data->service,
-			 RLIMIT_RSS, 1024);
+			 RLIMIT_RSS, 1024, data->plan);
 
 #ifdef RLIMIT_SIGPENDING
 	/* for some reason, this seems missing on some systems */
 	/* Handle RLIMIT_SIGPENDING */
 	ret += set_limit(&RLIMIT_SIGPENDING_SOFT, &RLIMIT_SIGPENDING_HARD,
-			 data->service, RLIMIT_SIGPENDING, 1);
+			 data->service, RLIMIT_SIGPENDING, 1, data->plan);
 #endif
 
 	/* Handle RLIMIT_STACK */
 	ret += set_limit(&RLIMIT_STACK_SOFT, &RLIMIT_STACK_HARD,
-			 data->service, RLIMIT_STACK, 1024);
+			 data->service, RLIMIT_STACK, 1024, data->plan);
 
 	/* make sure every rlimit suceeded */
 	if (ret != 0)
@@ -372,7 +369,7 @@ int module_init(void)
 	initng_service_data_type_register(&RLIMIT_STACK_HARD);
 
 	/* add the after fork function hook */
-	initng_event_hook_register(&EVENT_AFTER_FORK, &do_limit);
+	initng_event_hook_register(&EVENT_SPAWN_PLAN, &do_limit);
 
 	/* always return happily */
 	return TRUE;
@@ -381,7 +378,7 @@ int module_init(void)
 void module_unload(void)
 {
 	/* remove the hook */
-	initng_event_hook_unregister(&EVENT_AFTER_FORK, &do_limit);
+	initng_event_hook_unregister(&EVENT_SPAWN_PLAN, &do_limit);
 
 	/* Del all options to initng */
 	initng_service_data_type_unregister(&RLIMIT_AS_SOFT);
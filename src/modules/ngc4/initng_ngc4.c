@@ -94,32 +94,6 @@ static void fdh_handler(s_event * event)
 			close(fdh.fds);
 		break;
 
-	case IOW_ACTION_CHECK:
-		if (fdh.fds <= 2)
-			break;
-
-		/* This is a expensive test, but better safe then sorry */
-		if (!STILL_OPEN(fdh.fds)) {
-			D_("%i is not open anymore.\n", fdh.fds);
-			fdh.fds = -1;
-			break;
-		}
-
-		FD_SET(fdh.fds, data->readset);
-		data->added++;
-		break;
-
-	case IOW_ACTION_CALL:
-		if (!data->added || fdh.fds <= 2)
-			break;
-
-		if (!FD_ISSET(fdh.fds, data->readset))
-			break;
-
-		accepted_client(&fdh, IOW_READ);
-		data->added--;
-		break;
-
 	case IOW_ACTION_DEBUG:
 		if (!data->debug_find_what ||
 		    strstr(__FILE__, data->debug_find_what)) {
@@ -162,7 +136,8 @@ static void closesock(void)
 
 	D_("closesock %d\n", fdh.fds);
 
-	/* close socket and set to 0 */
+	/* stop polling, close socket and set to 0 */
+	initng_io_fd_unregister(&fdh);
 	close(fdh.fds);
 	fdh.fds = -1;
 }
@@ -672,6 +647,9 @@ static int open_socket()
 		return FALSE;
 	}
 
+	/* let the main loop call accepted_client() */
+	initng_io_fd_register(&fdh);
+
 	/* Run check : */
 	if (!sendping()) {
 		F_("Sendping check failed, ngc2 communication not available "
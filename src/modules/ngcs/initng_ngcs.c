@@ -110,32 +110,6 @@ static void fdh_handler(s_event * event)
 			close(fdh.fds);
 		break;
 
-	case IOW_ACTION_CHECK:
-		if (fdh.fds <= 2)
-			break;
-
-		/* This is a expensive test, but better safe then sorry */
-		if (!STILL_OPEN(fdh.fds)) {
-			D_("%i is not open anymore.\n", fdh.fds);
-			fdh.fds = -1;
-			break;
-		}
-
-		FD_SET(fdh.fds, data->readset);
-		data->added++;
-		break;
-
-	case IOW_ACTION_CALL:
-		if (!data->added || fdh.fds <= 2)
-			break;
-
-		if (!FD_ISSET(fdh.fds, data->readset))
-			break;
-
-		accepted_client(&fdh, IOW_READ);
-		data->added--;
-		break;
-
 	case IOW_ACTION_DEBUG:
 		if (!data->debug_find_what ||
 		    strstr(__FILE__, data->debug_find_what)) {
@@ -163,34 +137,6 @@ static void conn_fdw_handler(s_event * event)
 				close(current->fdw.fds);
 			break;
 
-		case IOW_ACTION_CHECK:
-			if (current->fdw.fds <= 2)
-				break;
-
-			/* This is a expensive test, but better safe
-			 * then sorry */
-			if (!STILL_OPEN(current->fdw.fds)) {
-				D_("%i is not open anymore.\n",
-				   current->fdw.fds);
-				current->fdw.fds = -1;
-				break;
-			}
-
-			FD_SET(current->fdw.fds, data->readset);
-			data->added++;
-			break;
-
-		case IOW_ACTION_CALL:
-			if (!data->added || current->fdw.fds <= 2)
-				break;
-
-			if (!FD_ISSET(current->fdw.fds, data->readset))
-				break;
-
-			current->fdw.call_module(&current->fdw, IOW_READ);
-			data->added--;
-			break;
-
 		case IOW_ACTION_DEBUG:
 			if (!data->debug_find_what ||
 			    strstr(__FILE__, data->debug_find_what)) {
@@ -210,7 +156,8 @@ static void closesock(void)
 		return;
 	D_("closesock %d\n", fdh.fds);
 
-	/* close socket and set to 0 */
+	/* stop polling, close socket and set to 0 */
+	initng_io_fd_unregister(&fdh);
 	close(fdh.fds);
 	fdh.fds = -1;
 }
@@ -285,6 +232,7 @@ void accepted_client(f_module_h * from, e_fdw what)
 		conn->list.next = 0;
 		conn->list.prev = 0;
 		initng_list_add(&conn->list, &ngcs_conns.list);
+		initng_io_fd_register(&conn->fdw);
 		return;
 	}
 
@@ -304,6 +252,7 @@ static void handle_close(ngcs_conn * conn)
 {
 	ngcs_svr_conn *sconn = (ngcs_svr_conn *) conn->userdata;
 
+	initng_io_fd_unregister(&sconn->fdw);
 	sconn->fdw.fds = -1;
 	initng_list_move(&sconn->list, &ngcs_dead_conns.list);
 }
@@ -326,6 +275,10 @@ static void pollmode_hook(ngcs_conn * conn, int have_pending_writes)
 	ngcs_svr_conn *sconn = (ngcs_svr_conn *) conn->userdata;
 
 	sconn->fdw.what = IOW_READ | (have_pending_writes ? IOW_WRITE : 0);
+
+	/* not registered until the connection is set up */
+	if (sconn->fdw.call_module)
+		initng_io_fd_update(&sconn->fdw);
 }
 
 static void handle_chan0(ngcs_chan * chan, int type, int len, char *data)
@@ -649,6 +602,9 @@ static int open_socket()
 		return FALSE;
 	}
 
+	/* let the main loop call accepted_client() */
+	initng_io_fd_register(&fdh);
+
 	/* Run check : */
 	/*    if (!sendping())
 	   {
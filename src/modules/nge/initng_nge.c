@@ -92,32 +92,6 @@ static void io_event_acceptor_handler(s_event * event)
 			close(io_event_acceptor.fds);
 		break;
 
-	case IOW_ACTION_CHECK:
-		if (io_event_acceptor.fds <= 2)
-			break;
-
-		/* This is a expensive test, but better safe then sorry */
-		if (!STILL_OPEN(io_event_acceptor.fds)) {
-			D_("%i is not open anymore.\n", io_event_acceptor.fds);
-			io_event_acceptor.fds = -1;
-			break;
-		}
-
-		FD_SET(io_event_acceptor.fds, data->readset);
-		data->added++;
-		break;
-
-	case IOW_ACTION_CALL:
-		if (!data->added || io_event_acceptor.fds <= 2)
-			break;
-
-		if (!FD_ISSET(io_event_acceptor.fds, data->readset))
-			break;
-
-		event_acceptor(&io_event_acceptor, IOW_READ);
-		data->added--;
-		break;
-
 	case IOW_ACTION_DEBUG:
 		if (!data->debug_find_what ||
 		    strstr(__FILE__, data->debug_find_what)) {
@@ -198,7 +172,8 @@ static void close_initiator_socket(void)
 		is_active = FALSE;
 	}
 
-	/* close socket and set to 0 */
+	/* stop polling, close socket and set to 0 */
+	initng_io_fd_unregister(&io_event_acceptor);
 	close(io_event_acceptor.fds);
 	io_event_acceptor.fds = -1;
 
@@ -429,9 +404,10 @@ static int open_initiator_socket(void)
 	}
 
 	/*
-	 * Add an hook, so when io_event_acceptor.fds have data,
+	 * Watch io_event_acceptor.fds, so when it have data,
 	 * io_event_acceptor.call (event_acceptor()) is called.
 	 */
+	initng_io_fd_register(&io_event_acceptor);
 	initng_event_hook_register(&EVENT_IO_WATCHER,
 				   &io_event_acceptor_handler);
 
@@ -48,6 +48,25 @@ s_entry MS_DELAY = {
 	.ot = NULL,
 };
 
+/* the pause is done in the child, so it has to be forked */
+static void plan_pause(s_event * event)
+{
+	s_event_spawn_plan_data *data;
+
+	assert(event->event_type == &EVENT_SPAWN_PLAN);
+	assert(event->data);
+
+	data = event->data;
+
+	assert(data->service);
+	assert(data->process);
+	assert(data->process->pt);
+
+	if (get_int_var(&S_DELAY, data->process->pt->name, data->service) ||
+	    get_int_var(&MS_DELAY, data->process->pt->name, data->service))
+		data->plan->fork = TRUE;
+}
+
 static void do_pause(s_event * event)
 {
 	s_event_after_fork_data *data;
@@ -85,6 +104,7 @@ int module_init(void)
 {
 	initng_service_data_type_register(&S_DELAY);
 	initng_service_data_type_register(&MS_DELAY);
+	initng_event_hook_register(&EVENT_SPAWN_PLAN, &plan_pause);
 	return (initng_event_hook_register(&EVENT_AFTER_FORK, &do_pause));
 }
 
@@ -92,5 +112,6 @@ void module_unload(void)
 {
 	initng_service_data_type_unregister(&S_DELAY);
 	initng_service_data_type_unregister(&MS_DELAY);
+	initng_event_hook_unregister(&EVENT_SPAWN_PLAN, &plan_pause);
 	initng_event_hook_unregister(&EVENT_AFTER_FORK, &do_pause);
 }
@@ -206,19 +206,22 @@ static int read_file(const char *filename)
 					continue;
 
 				/* fill the data */
-				process->pid = entry.process[pnr].pid;
+				initng_process_db_set_pid(process, new_entry,
+						entry.process[pnr].pid);
 
 				/* for every pipe */
 				while (entry.process[pnr].pipes[p].dir > 0 &&
 				       p < MAX_PIPES) {
 					int i;
-					pipe_h *op = initng_toolbox_calloc(1,
-									   sizeof
-									   (pipe_h));
+					pipe_h *op = initng_process_db_pipe_new(
+					    entry.process[pnr].pipes[p].dir);
 
+					/* drop the whole process */
 					if (!op) {
-						free(process);
-						continue;
+						initng_process_db_real_free(
+							process);
+						process = NULL;
+						break;
 					}
 
 					op->pipe[0] =
@@ -240,12 +243,20 @@ static int read_file(const char *filename)
 					add_pipe(op, process);
 					p++;
 				}
+
+				if (!process) {
+					pnr++;
+					continue;
+				}
 				process->r_code = entry.process[pnr].rcode;
 
 				/* add this process to the list */
 				initng_list_add(&process->list,
 						&new_entry->processes.list);
 
+				/* poll the pipes we got back */
+				initng_io_process_register(new_entry, process);
+
 				D_("Added process type %s to %s\n",
 				   process->pt->name, new_entry->name);
 
@@ -257,9 +268,7 @@ static int read_file(const char *filename)
 			int i = 0;
 
 			while (entry.data[i].opt_type) {
-				d = (s_data *) initng_toolbox_calloc(1,
-								     sizeof
-								     (s_data));
+				d = (s_data *) initng_slab_alloc(&initng_slab_data);
 
 				d->type =
 				    initng_service_data_type_find(entry.data[i].
@@ -268,7 +277,8 @@ static int read_file(const char *filename)
 				if (!d->type) {
 					F_("Did not found %s!\n",
 					   entry.data[i].type);
-					free(d);
+					initng_slab_free(&initng_slab_data,
+							 d);
 					i++;
 					continue;
 				}
@@ -298,8 +308,7 @@ static int read_file(const char *filename)
 					d->vn = initng_toolbox_strdup(
 							entry.data[i].vn);
 
-				initng_list_add(&d->list,
-						&new_entry->data.head.list);
+				initng_data_add(&new_entry->data, d);
 				i++;
 			}
 		}
@@ -411,16 +420,18 @@ static int read_file_v13(const char *filename)
 					continue;
 
 				/* fill the data */
-				process->pid = entry.process[pnr].pid;
+				initng_process_db_set_pid(process, new_entry,
+						entry.process[pnr].pid);
 
 				/* for every pipe */
 				{
-					pipe_h *op = initng_toolbox_calloc(1,
-									   sizeof
-									   (pipe_h));
+					pipe_h *op = initng_process_db_pipe_new(
+					    BUFFERED_OUT_PIPE);
 
 					if (!op) {
-						free(process);
+						initng_process_db_real_free(
+							process);
+						pnr++;
 						continue;
 					}
 
@@ -440,6 +451,9 @@ static int read_file_v13(const char *filename)
 				initng_list_add(&process->list,
 						&new_entry->processes.list);
 
+				/* poll the pipes we got back */
+				initng_io_process_register(new_entry, process);
+
 				D_("Added process type %s to %s\n",
 				   process->pt->name, new_entry->name);
 
@@ -451,16 +465,15 @@ static int read_file_v13(const char *filename)
 			int i = 0;
 
 			while (entry.data[i].opt_type) {
-				d = (s_data *) initng_toolbox_calloc(1,
-								     sizeof
-								     (s_data));
+				d = (s_data *) initng_slab_alloc(&initng_slab_data);
 				d->type =
 				    initng_service_data_type_find(entry.data[i].
 								  type);
 				if (!d->type) {
 					F_("Did not found %s!\n",
 					   entry.data[i].type);
-					free(d);
+					initng_slab_free(&initng_slab_data,
+							 d);
 					i++;
 					continue;
 				}
@@ -487,8 +500,7 @@ static int read_file_v13(const char *filename)
 
 				d->vn = NULL;
 
-				initng_list_add(&d->list,
-						&new_entry->data.head.list);
+				initng_data_add(&new_entry->data, d);
 				i++;
 			}
 		}
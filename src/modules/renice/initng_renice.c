@@ -43,9 +43,9 @@ s_entry NICE = {
 
 static void do_renice(s_event * event)
 {
-	s_event_after_fork_data *data;
+	s_event_spawn_plan_data *data;
 
-	assert(event->event_type == &EVENT_AFTER_FORK);
+	assert(event->event_type == &EVENT_SPAWN_PLAN);
 	assert(event->data);
 
 	data = event->data;
@@ -57,24 +57,19 @@ static void do_renice(s_event * event)
 	if (is(&NICE, data->service)) {
 		D_("Will renice %s to %i !\n", data->service->name,
 		   get_int(&NICE, data->service));
-		errno = 0;
-		if (nice(get_int(&NICE, data->service)) == -1 && errno != 0) {
-			F_("Failed to set the nice value: %s\n",
-			   strerror(errno));
-			event->status = FAILED;
-			return;
-		}
+		data->plan->set_nice = TRUE;
+		data->plan->nice = get_int(&NICE, data->service);
 	}
 }
 
 int module_init(void)
 {
 	initng_service_data_type_register(&NICE);
-	return (initng_event_hook_register(&EVENT_AFTER_FORK, &do_renice));
+	return (initng_event_hook_register(&EVENT_SPAWN_PLAN, &do_renice));
 }
 
 void module_unload(void)
 {
 	initng_service_data_type_unregister(&NICE);
-	initng_event_hook_unregister(&EVENT_AFTER_FORK, &do_renice);
+	initng_event_hook_unregister(&EVENT_SPAWN_PLAN, &do_renice);
 }
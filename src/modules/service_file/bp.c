@@ -35,6 +35,8 @@
 #include <assert.h>
 #include <errno.h>
 #include <poll.h>
+#include <stdarg.h>
+#include <sys/stat.h>
 
 #include <sys/types.h>	/* unix domain sockets */
 #include <sys/socket.h>
@@ -52,27 +54,32 @@
 
 typedef struct {
 	const char *name;
-	int (*function) (bp_req *to_send, int argc, char **argv);
-	bp_req_type req_type;
+	int (*function) (const char *service, int argc, char **argv);
+	int batched;		/* kept for the next command that is not */
 } command_entry;
 
 
 static int call_command(command_entry *cmd, char *service, int argc,
 			char **argv);
 
-static int bp_send(bp_req * to_send);
+static int bp_send(int batched);
 
 /* these are gonna be used for main() for every command */
 
-static int bp_trivial(bp_req *to_send, int argc, char **argv);
-static int bp_new_active(bp_req *to_send, int argc, char **argv);
-static int bp_get_variable(bp_req *to_send, int argc, char **argv);
-static int bp_set_variable(bp_req *to_send, int argc, char **argv);
-static int bp_add_exec(bp_req *to_send, int argc, char **argv);
-static int unknown_command(bp_req *to_send, int argc, char **argv);
+static int bp_abort(const char *service, int argc, char **argv);
+static int bp_done(const char *service, int argc, char **argv);
+static int bp_new_active(const char *service, int argc, char **argv);
+static int bp_get_variable(const char *service, int argc, char **argv);
+static int bp_set_variable(const char *service, int argc, char **argv);
+static int bp_add_exec(const char *service, int argc, char **argv);
+static int unknown_command(const char *service, int argc, char **argv);
 
 char *message;
 
+/* the records to send */
+static char *out = NULL;
+static size_t out_len = 0;
+
 enum command_map {
 	IUNKNOWN = 0,
 	IABORT,
@@ -84,16 +91,16 @@ enum command_map {
 };
 
 command_entry commands[] = {
-	[IUNKNOWN]  = {NULL,        &unknown_command, 0},
-	[IABORT]    = {"iabort",    &bp_trivial,      ABORT},
-	[IREGISTER] = {"iregister", &bp_new_active,   NEW_ACTIVE},
-	[IDONE]     = {"idone",     &bp_trivial,      DONE},
-	[IGET]      = {"iget",      &bp_get_variable, GET_VARIABLE},
-	[ISET]      = {"iset",      &bp_set_variable, SET_VARIABLE},
-	[IEXEC]     = {"iexec",     &bp_add_exec,     SET_VARIABLE},
+	[IUNKNOWN]  = {NULL,        &unknown_command, FALSE},
+	[IABORT]    = {"iabort",    &bp_abort,        FALSE},
+	[IREGISTER] = {"iregister", &bp_new_active,   FALSE},
+	[IDONE]     = {"idone",     &bp_done,         FALSE},
+	[IGET]      = {"iget",      &bp_get_variable, FALSE},
+	[ISET]      = {"iset",      &bp_set_variable, TRUE},
+	[IEXEC]     = {"iexec",     &bp_add_exec,     TRUE},
 };
 
-static int unknown_command(bp_req *to_send, int argc, char **argv)
+static int unknown_command(const char *service, int argc, char **argv)
 {
 	printf("Bad command \"");
 	for (int i = 0; argv[i]; i++)
@@ -142,15 +149,36 @@ static command_entry *map_cmd(const char *cmd)
 static int call_command(command_entry *cmd, char *service, int argc,
 			char **argv)
 {
-	bp_req to_send;
+	if (!(cmd->function)(service, argc, argv))
+		return FALSE;
+
+	return bp_send(cmd->batched);
+}
 
-	if (cmd->req_type) {
-		memset(&to_send, 0, sizeof(to_send));
-		to_send.request = cmd->req_type;
-		strncpy(to_send.service, service, 100);
+/* add a record, with the strings after service up to a NULL */
+static void add_rec(bp_req_type request, const char *service, ...)
+{
+	bp_rec rec;
+	const char *s;
+	va_list ap;
+	size_t at = out_len;
+
+	out = realloc(out, out_len + sizeof(bp_rec) + strlen(service) + 1);
+	out_len += sizeof(bp_rec);
+	strcpy(&out[out_len], service);
+	out_len += strlen(service) + 1;
+
+	va_start(ap, service);
+	while ((s = va_arg(ap, const char *))) {
+		out = realloc(out, out_len + strlen(s) + 1);
+		strcpy(&out[out_len], s);
+		out_len += strlen(s) + 1;
 	}
+	va_end(ap);
 
-	return (cmd->function)(&to_send, argc, argv);
+	rec.len = out_len - at - sizeof(bp_rec);
+	rec.request = request;
+	memcpy(&out[at], &rec, sizeof(bp_rec));
 }
 
 
@@ -180,10 +208,10 @@ int main(int argc, char **argv)
 		exit(1);
 	}
 
-	/* copy all entries */
+	/* copy all entries, after the path */
 	new_argc = 0;
 	for (int i = 1; argv[i]; i++) {
-		new_argv[new_argc++] = argv[i];
+		new_argv[++new_argc] = argv[i];
 	}
 
 	if (DEBUG_EXTRA) {
@@ -212,45 +240,40 @@ int main(int argc, char **argv)
  * usage: iexec start           will run /etc/initng/service internal_start
  *        iexec start = dodo    will run /etc/initng/service internal_dodo
  */
-static int bp_add_exec(bp_req *to_send, int argc, char **argv)
+static int bp_add_exec(const char *service, int argc, char **argv)
 {
 	if (argc != 1 && (argc != 3 || argv[2][0] != '='))
 		return FALSE;
 
-	int left = 1024;
+	char *value;
+	const char *what = (argc == 1 ? argv[1] : argv[3]);
 
 	if (argc != 3 || argv[3][0] != '/') {
-		/* "/etc/initng/file" */
-		strncpy(to_send->u.set_variable.value, argv[0], left);
-		left -= strlen(argv[0]);
-
-		/* " internal_" */
-		strncat(to_send->u.set_variable.value, " internal_", left);
-		left -= strlen(" internal_");
-	}
-
-	if (argc == 1) {
-		/* "start" */
-		strncat(to_send->u.set_variable.value, argv[1], left);
-		left -= strlen(argv[1]);
-	} else {
-		/* "dodo" */
-		strncat(to_send->u.set_variable.value, argv[3], left);
-		left -= strlen(argv[3]);
-	}
+		/* "/etc/initng/file internal_start" */
+		value = malloc(strlen(argv[0]) + strlen(what) + 11);
+		strcpy(value, argv[0]);
+		strcat(value, " internal_");
+		strcat(value, what);
+	} else
+		value = strdup(what);
 
-	/* the type is "exec" */
-	strncpy(to_send->u.set_variable.vartype, "exec", 100);
+	/* the type is "exec", the varname is "start" */
+	add_rec(SET_VARIABLE, service, "exec", argv[1], value, NULL);
+	free(value);
 
-	/* the varname is "start" */
-	strncpy(to_send->u.set_variable.varname, argv[1], 100);
+	return TRUE;
+}
 
-	return bp_send(to_send);
+static int bp_abort(const char *service, int argc, char **argv)
+{
+	add_rec(ABORT, service, NULL);
+	return TRUE;
 }
 
-static int bp_trivial(bp_req *to_send, int argc, char **argv)
+static int bp_done(const char *service, int argc, char **argv)
 {
-	return bp_send(to_send);
+	add_rec(DONE, service, NULL);
+	return TRUE;
 }
 
 /* This have 2 senarios, with 1 or 2 argc:
@@ -258,19 +281,15 @@ static int bp_trivial(bp_req *to_send, int argc, char **argv)
  *  iget exec test
  */
 
-static int bp_get_variable(bp_req *to_send, int argc, char **argv)
+static int bp_get_variable(const char *service, int argc, char **argv)
 {
 	/* make sure its 1 or 2 args with this */
 	if (argc != 1 && argc != 2)
 		return FALSE;
 
-	if (argc == 2) {
-		strncpy(to_send->u.get_variable.varname, argv[1], 100);
-		argv++;
-	}
-	strncpy(to_send->u.get_variable.vartype, argv[1], 100);
-
-	return bp_send(to_send);
+	add_rec(GET_VARIABLE, service, argv[1], argc == 2 ? argv[2] : "",
+		NULL);
+	return TRUE;
 }
 
 /*
@@ -285,7 +304,7 @@ static int bp_get_variable(bp_req *to_send, int argc, char **argv)
  *  4) iset exec test = "Coool"
  */
 
-static int bp_set_variable(bp_req *to_send, int argc, char **argv)
+static int bp_set_variable(const char *service, int argc, char **argv)
 {
 	/* make sure have enough params */
 	if (argc < 1)
@@ -293,60 +312,101 @@ static int bp_set_variable(bp_req *to_send, int argc, char **argv)
 
 	/* value-less variable */
 	if (argc < 3) {
-		/* type 1: type-only */
-		strncpy(to_send->u.set_variable.vartype, argv[1], 100);
-
-		/* type 2: type+name */
-		if (argc == 2)
-			strncpy(to_send->u.set_variable.varname, argv[2], 100);
-		return bp_send(to_send);
+		/* type 1: type-only, type 2: type+name */
+		add_rec(SET_VARIABLE, service, argv[1],
+			argc == 2 ? argv[2] : "", "", NULL);
+		return TRUE;
 	}
 
-	strncpy(to_send->u.set_variable.vartype, argv[1], 100);
-
+	const char *varname;
 	int i;
 
 	/* type 3: short set without varname */
 	if (argv[2][0] == '=') {
 		/* argv[2] == '=' */
+		varname = "";
 		i = 3;
 	}
 	/* else type 4 */
 	else if (argc >= 4 && argv[3][0] == '=') {
-		strncpy(to_send->u.set_variable.varname, argv[2], 100);
+		varname = argv[2];
 		/* argv[3] == '=' */
 		i = 4;
 	} else
 		return FALSE;
 
-	for (; argv[i]; i++) {
-		strncpy(to_send->u.set_variable.value, argv[i], 1024);
-		if (!bp_send(to_send))
-			return FALSE;
-	}
+	for (; argv[i]; i++)
+		add_rec(SET_VARIABLE, service, argv[1], varname, argv[i], NULL);
 
 	return TRUE;
 }
 
-static int bp_new_active(bp_req *to_send, int argc, char **argv)
+static int bp_new_active(const char *service, int argc, char **argv)
 {
 	/* do a check */
 	if (argc != 1)
 		return FALSE;
 
-	/* set the type */
-	strncpy(to_send->u.new_active.type, argv[1], 40);
-	strncpy(to_send->u.new_active.from_file, argv[0], 100);
+	/* the type, and the file */
+	add_rec(NEW_ACTIVE, service, argv[1], argv[0], NULL);
+	return TRUE;
+}
 
-	return bp_send(to_send);
+/*
+ * With BP_BATCH set by the script, the batched commands are only kept,
+ * in the file initng gave the parse on BATCH_FD, and sent with the next
+ * command that is not. What is left there when the parse exits initng
+ * handles itself. A kept command always succeeds, so "iset ... || exit"
+ * does not stop there; initng warns if it failed, like version 1 did.
+ */
+static int batching(void)
+{
+	return getenv("BP_BATCH") && fcntl(BATCH_FD, F_GETFD) >= 0;
+}
+
+static int bp_keep(void)
+{
+	if (write(BATCH_FD, out, out_len) != (ssize_t) out_len) {
+		message = strdup("Unable to keep the request.");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* put what was kept in front of the records to send */
+static void bp_take_kept(void)
+{
+	struct stat st;
+	char *all;
+
+	if (fstat(BATCH_FD, &st) != 0 || st.st_size <= 0)
+		return;
+
+	if (!(all = malloc(st.st_size + out_len)))
+		return;
+
+	/* they go with this one, and are kept no more */
+	if (pread(BATCH_FD, all, st.st_size, 0) != st.st_size ||
+	    ftruncate(BATCH_FD, 0) < 0) {
+		free(all);
+		return;
+	}
+
+	memcpy(&all[st.st_size], out, out_len);
+	free(out);
+	out = all;
+	out_len += st.st_size;
 }
 
 /* Open, Send, Read, Close */
-static int bp_send(bp_req * to_send)
+static int bp_send(int batched)
 {
 	int sock = 3;		/* testing fd 3, that is the oficcial pipe to initng for this communication */
 	int len;
 	struct sockaddr_un sockname;
+	bp_batch batch;
+	size_t sent;
 	int e;
 
 	/* the reply from initng */
@@ -354,8 +414,15 @@ static int bp_send(bp_req * to_send)
 
 	memset(&rep, 0, sizeof(bp_rep));
 
-	assert(to_send);
-	to_send->version = SERVICE_FILE_VERSION;
+	if (batching()) {
+		if (batched)
+			return bp_keep();
+
+		bp_take_kept();
+	}
+
+	batch.version = SERVICE_FILE_BATCH_VERSION;
+	batch.len = out_len;
 
 	/* check if we can use fd 3 to talk to initng */
 	if (fcntl(sock, F_GETFD) < 0) {
@@ -379,9 +446,12 @@ static int bp_send(bp_req * to_send)
 		}
 	}
 
-	/* send the request */
-	e = send(sock, to_send, sizeof(bp_req), 0);
-	if (e != (signed)sizeof(bp_req)) {
+	/* send the batch, all of it */
+	e = send(sock, &batch, sizeof(bp_batch), 0);
+	for (sent = 0; e > 0 && sent < out_len; sent += e)
+		e = send(sock, &out[sent], out_len - sent, 0);
+
+	if (e < 0) {
 		char *m = strerror(errno);
 		message = calloc(501, 1);
 		snprintf(message, 500, "Unable to send the request: "
@@ -389,10 +459,7 @@ static int bp_send(bp_req * to_send)
 		return FALSE;
 	}
 
-	/* sleep to give initng a chanse */
-	usleep(200);
-
-	e = recv(sock, &rep, sizeof(bp_rep), 0);
+	e = recv(sock, &rep, sizeof(bp_rep), MSG_WAITALL);
 
 	if (e != (signed)sizeof(bp_rep)) {
 		char *m = strerror(errno);
@@ -0,0 +1,633 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+#include <initng-paths.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <assert.h>
+
+#include "initng_service_file.h"
+
+/*
+ * The parse cache.
+ *
+ * What a service file sets for a service is saved when it is parsed,
+ * and set straight from the cache the next time the service is asked
+ * for, as long as it comes from the same file with the same mtime and
+ * size. A script is run by its wrapper, that may source the conf.d file
+ * of the service too, so their mtime and size are kept for it as well.
+ * The cache file is mapped, and a record is only read when its service
+ * is. fmon tells about changed files with the forget_service_file
+ * command, so they are dropped right away.
+ */
+
+#define CACHE_FILE	VARDIR "/initng_service_file.cache"
+#define CACHE_MAGIC	"INSF"
+#define CACHE_VERSION	2
+#define CACHE_BUCKETS	64
+
+/* what a script is run with, besides its file, see runiscript.c */
+#define WRAPPER_PATH	INITNG_MODULE_DIR "/wrappers/"
+#define CONFD_PATH	"/etc/conf.d/"
+#define CACHE_INPUTS	2
+
+/* room for the stamp of an input */
+#define STAMP_LEN	48
+
+/* records are padded, to keep the record headers aligned */
+#define PAD(len)	(((len) + 7) & ~(size_t)7)
+
+typedef struct {
+	char magic[4];
+	uint32_t version;
+	uint32_t count;
+	uint32_t pad;
+} s_cache_header;
+
+/*
+ * A record is followed by the service name, the file, the service type,
+ * path and stamp of every other input, and then type, varname and value
+ * of every entry, all as strings.
+ */
+typedef struct {
+	uint32_t len;		/* of the whole record, padded */
+	uint32_t entries;
+	uint32_t inputs;
+	uint32_t pad;
+	int64_t mtime;
+	int64_t size;
+} s_cache_rec;
+
+typedef struct s_cached_s {
+	const char *name;
+	hash_t hash;
+	s_cache_rec *rec;
+	int own;		/* rec is allocated, not mapped */
+	list_t list;
+} s_cached;
+
+static list_t cached[CACHE_BUCKETS];
+static void *map = NULL;
+static size_t map_len = 0;
+static int dirty = FALSE;
+
+static int cmd_forget(void *data);
+
+s_command FORGET_SERVICE_FILE = {
+	.id = 'F',
+	.long_id = "forget_service_file",
+	.com_type = INT_COMMAND,
+	.opt_visible = HIDDEN_COMMAND,
+	.opt_type = USES_OPT,
+	.u = {(void *)&cmd_forget},
+	.description = "Drop a changed service file from the parse cache"
+};
+
+/* the strings of rec, in order */
+static const char *next_string(const char **p)
+{
+	const char *s = *p;
+
+	*p += strlen(s) + 1;
+	return s;
+}
+
+static s_cached *find(const char *name)
+{
+	s_cached *current;
+	hash_t hash = initng_hash_str(name);
+
+	initng_list_foreach(current, &cached[hash % CACHE_BUCKETS], list) {
+		if (current->hash == hash && strcmp(current->name, name) == 0)
+			return current;
+	}
+
+	return NULL;
+}
+
+static void drop(s_cached * c)
+{
+	initng_list_del(&c->list);
+	if (c->own)
+		free(c->rec);
+	free(c);
+	dirty = TRUE;
+}
+
+static void add(s_cache_rec * rec, int own)
+{
+	s_cached *c;
+	const char *name = (const char *)(rec + 1);
+
+	if ((c = find(name)))
+		drop(c);
+
+	c = initng_toolbox_calloc(1, sizeof(s_cached));
+	c->name = name;
+	c->hash = initng_hash_str(name);
+	c->rec = rec;
+	c->own = own;
+	initng_list_add(&c->list, &cached[c->hash % CACHE_BUCKETS]);
+}
+
+/* mtime and size of path, as a string, "-" if it is not there */
+static void stamp(char *out, const char *path)
+{
+	struct stat st;
+
+	if (stat(path, &st) != 0)
+		strcpy(out, "-");
+	else
+		snprintf(out, STAMP_LEN, "%lld:%lld", (long long)st.st_mtime,
+			 (long long)st.st_size);
+}
+
+/* the first entry of rec */
+static const char *first_entry(s_cache_rec * rec)
+{
+	const char *p = (const char *)(rec + 1);
+	uint32_t i;
+
+	for (i = 0; i < 3 + 2 * rec->inputs; i++)
+		next_string(&p);
+
+	return p;
+}
+
+/* the record is for file, and the other inputs, as they are now */
+static int fresh(s_cache_rec * rec, const char *file, struct stat *st)
+{
+	const char *p = (const char *)(rec + 1);
+	char now[STAMP_LEN];
+	uint32_t i;
+
+	next_string(&p);
+	if (rec->mtime != (int64_t) st->st_mtime ||
+	    rec->size != (int64_t) st->st_size ||
+	    strcmp(next_string(&p), file) != 0)
+		return FALSE;
+
+	next_string(&p);
+	for (i = 0; i < rec->inputs; i++) {
+		stamp(now, next_string(&p));
+		if (strcmp(next_string(&p), now) != 0)
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+static int cacheable(s_entry * type)
+{
+	switch (type->type) {
+	case STRING:
+	case STRINGS:
+	case SET:
+	case INT:
+	case VARIABLE_STRING:
+	case VARIABLE_STRINGS:
+	case VARIABLE_SET:
+	case VARIABLE_INT:
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
+/*
+ * Set service from the cache, if there is a fresh record for it from
+ * file. It is then done parsing, like after an idone.
+ */
+int service_file_cache_apply(active_db_h * service, const char *file,
+			     struct stat *st)
+{
+	s_cached *c;
+	stype_h *stype;
+	const char *p;
+	bp_req req;
+	bp_rep rep;
+	uint32_t i;
+
+	assert(service);
+	assert(file);
+
+	if (!(c = find(service->name)))
+		return FALSE;
+
+	if (!fresh(c->rec, file, st)) {
+		drop(c);
+		return FALSE;
+	}
+
+	p = (const char *)(c->rec + 1);
+	next_string(&p);
+	next_string(&p);
+
+	/* the type, and every entry, must be known before any is set */
+	if (!(stype = initng_service_type_get_by_name(next_string(&p))))
+		return FALSE;
+
+	p = first_entry(c->rec);
+	for (i = 0; i < c->rec->entries; i++) {
+		s_entry *type = initng_service_data_type_find(next_string(&p));
+
+		if (!type || !cacheable(type))
+			return FALSE;
+		next_string(&p);
+		next_string(&p);
+	}
+
+	D_("Setting %s from the parse cache.\n", service->name);
+
+	p = first_entry(c->rec);
+
+	for (i = 0; i < c->rec->entries; i++) {
+		s_entry *type = initng_service_data_type_find(next_string(&p));
+		const char *vn = next_string(&p);
+		const char *value = next_string(&p);
+		char *name = *vn ? initng_toolbox_strdup(vn) : NULL;
+
+		switch (type->type) {
+		case STRING:
+		case VARIABLE_STRING:
+			set_string_var(type, name, service,
+				       initng_toolbox_strdup(value));
+			break;
+
+		case STRINGS:
+		case VARIABLE_STRINGS:
+			set_another_string_var(type, name, service,
+					       initng_toolbox_strdup(value));
+			break;
+
+		case INT:
+		case VARIABLE_INT:
+			set_int_var(type, name, service, atoi(value));
+			break;
+
+		default:
+			set_var(type, name, service);
+			break;
+		}
+	}
+
+	service->type = stype;
+
+	/* as if it said idone */
+	memset(&req, 0, sizeof(bp_req));
+	memset(&rep, 0, sizeof(bp_rep));
+	req.version = SERVICE_FILE_VERSION;
+	req.request = DONE;
+	strncpy(req.service, service->name, 100);
+	bp_handle_req(&req, &rep);
+
+	service_file_parsed(service, !rep.success);
+	return TRUE;
+}
+
+/* copy s to out if set, returns the length with the '\0' */
+static size_t put(char *out, const char *s)
+{
+	size_t len = strlen(s) + 1;
+
+	if (out)
+		memcpy(out, s, len);
+	return len;
+}
+
+/*
+ * Write a record of service to out, if set, with the n inputs and their
+ * stamps. Returns the length of it, or 0 if it can't be cached.
+ */
+static size_t make_rec(char *out, active_db_h * service, const char *file,
+		       char **inputs, char stamps[][STAMP_LEN], int n)
+{
+	s_data *current;
+	size_t len = sizeof(s_cache_rec);
+	uint32_t entries = 0;
+	int i;
+
+	len += put(out ? out + len : NULL, service->name);
+	len += put(out ? out + len : NULL, file);
+	len += put(out ? out + len : NULL, service->type->name);
+
+	for (i = 0; i < n; i++) {
+		len += put(out ? out + len : NULL, inputs[i]);
+		len += put(out ? out + len : NULL, stamps[i]);
+	}
+
+	/* oldest first, so STRINGS come back in order */
+	initng_list_foreach_rev(current, &service->data.head.list, list) {
+		char num[24];
+		const char *value = "";
+
+		if (!current->type || !current->type->name ||
+		    !cacheable(current->type))
+			return 0;
+
+		switch (current->type->type) {
+		case INT:
+		case VARIABLE_INT:
+			snprintf(num, sizeof(num), "%i", current->t.i);
+			value = num;
+			break;
+
+		case SET:
+		case VARIABLE_SET:
+			break;
+
+		default:
+			if (current->t.s)
+				value = current->t.s;
+			break;
+		}
+
+		len += put(out ? out + len : NULL, current->type->name);
+		len += put(out ? out + len : NULL,
+			   current->vn ? current->vn : "");
+		len += put(out ? out + len : NULL, value);
+		entries++;
+	}
+
+	if (out) {
+		((s_cache_rec *) out)->entries = entries;
+		((s_cache_rec *) out)->inputs = n;
+	}
+
+	return PAD(len);
+}
+
+/*
+ * Save what service got from its file, when it is done parsing. A
+ * script got it through its wrapper and conf.d file too.
+ */
+void service_file_cache_store(active_db_h * service, int script)
+{
+	char *inputs[CACHE_INPUTS] = { NULL, NULL };
+	char stamps[CACHE_INPUTS][STAMP_LEN];
+	const char *file, *ext;
+	struct stat st;
+	s_cache_rec *rec;
+	s_cached *c;
+	size_t len;
+	int n = 0;
+	int i;
+
+	assert(service);
+
+	file = get_string(&FROM_FILE, service);
+	if (!file || !service->type || stat(file, &st) != 0)
+		return;
+
+	/* it came from the cache */
+	c = find(service->name);
+	if (c && fresh(c->rec, file, &st))
+		return;
+
+	if (script) {
+		ext = strrchr(initng_string_basename(file), '.');
+		initng_string_mprintf(&inputs[n++], WRAPPER_PATH "%s",
+				      ext && ext != initng_string_basename(file)
+				      ? ext + 1 : "default");
+		initng_string_mprintf(&inputs[n++], CONFD_PATH "%s",
+				      initng_string_basename(service->name));
+	}
+
+	for (i = 0; i < n; i++)
+		stamp(stamps[i], inputs[i]);
+
+	if (!(len = make_rec(NULL, service, file, inputs, stamps, n))) {
+		if (c)
+			drop(c);
+		goto out;
+	}
+
+	rec = initng_toolbox_calloc(1, len);
+	make_rec((char *)rec, service, file, inputs, stamps, n);
+	rec->len = len;
+	rec->mtime = st.st_mtime;
+	rec->size = st.st_size;
+
+	add(rec, TRUE);
+	dirty = TRUE;
+
+out:
+	for (i = 0; i < n; i++)
+		free(inputs[i]);
+}
+
+/* is there a '\0' in the len bytes from p */
+static int terminated(const char *p, size_t len)
+{
+	return memchr(p, '\0', len) != NULL;
+}
+
+static int valid(s_cache_rec * rec, size_t left)
+{
+	const char *p = (const char *)(rec + 1);
+	const char *end = (const char *)rec + rec->len;
+	uint32_t i;
+
+	if (left < sizeof(s_cache_rec) || rec->len < sizeof(s_cache_rec) ||
+	    rec->len > left || rec->len != PAD(rec->len))
+		return FALSE;
+
+	if (rec->inputs > CACHE_INPUTS)
+		return FALSE;
+
+	for (i = 0; i < 3 + 2 * rec->inputs + 3 * rec->entries; i++) {
+		if (p >= end || !terminated(p, end - p))
+			return FALSE;
+		next_string(&p);
+	}
+
+	return TRUE;
+}
+
+static void read_cache(void)
+{
+	s_cache_header *header;
+	struct stat st;
+	size_t pos;
+	uint32_t i;
+	int fd;
+
+	if ((fd = open(CACHE_FILE, O_RDONLY)) < 0)
+		return;
+
+	if (fstat(fd, &st) != 0 ||
+	    (size_t)st.st_size < sizeof(s_cache_header)) {
+		close(fd);
+		return;
+	}
+
+	map_len = st.st_size;
+	map = mmap(NULL, map_len, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (map == MAP_FAILED) {
+		map = NULL;
+		return;
+	}
+
+	header = map;
+	if (memcmp(header->magic, CACHE_MAGIC, 4) != 0 ||
+	    header->version != CACHE_VERSION) {
+		W_("%s is not a parse cache of this version.\n", CACHE_FILE);
+		dirty = TRUE;
+		return;
+	}
+
+	pos = sizeof(s_cache_header);
+	for (i = 0; i < header->count; i++) {
+		s_cache_rec *rec = (s_cache_rec *) ((char *)map + pos);
+
+		if (!valid(rec, map_len - pos)) {
+			F_("%s is broken, after %i services.\n", CACHE_FILE,
+			   (int)i);
+			dirty = TRUE;
+			break;
+		}
+
+		add(rec, FALSE);
+		pos += rec->len;
+	}
+
+	D_("Read %i services from the parse cache.\n", (int)i);
+}
+
+static void write_cache(void)
+{
+	s_cache_header header;
+	s_cached *current;
+	FILE *fil;
+	int i;
+
+	if (!dirty)
+		return;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CACHE_MAGIC, 4);
+	header.version = CACHE_VERSION;
+
+	for (i = 0; i < CACHE_BUCKETS; i++) {
+		initng_list_foreach(current, &cached[i], list)
+		    header.count++;
+	}
+
+	/* the old file may be mapped, write a new one over it */
+	if (!(fil = fopen(CACHE_FILE ".new", "w"))) {
+		D_("Can't write %s.\n", CACHE_FILE);
+		return;
+	}
+
+	fwrite(&header, sizeof(header), 1, fil);
+	for (i = 0; i < CACHE_BUCKETS; i++) {
+		initng_list_foreach(current, &cached[i], list)
+		    fwrite(current->rec, current->rec->len, 1, fil);
+	}
+
+	if (fclose(fil) != 0 || rename(CACHE_FILE ".new", CACHE_FILE) != 0) {
+		F_("Failed to write %s.\n", CACHE_FILE);
+		unlink(CACHE_FILE ".new");
+		return;
+	}
+
+	D_("Wrote %i services to the parse cache.\n", (int)header.count);
+	dirty = FALSE;
+}
+
+/* fmon calls this, with the file that changed, or NULL for all */
+static int cmd_forget(void *data)
+{
+	char *file = data;
+	s_cached *current, *safe = NULL;
+	int i;
+
+	for (i = 0; i < CACHE_BUCKETS; i++) {
+		initng_list_foreach_safe(current, safe, &cached[i], list) {
+			const char *p = current->name;
+
+			next_string(&p);
+			if (!file || !*file || strcmp(p, file) == 0)
+				drop(current);
+		}
+	}
+
+	/* it might be found somewhere else now */
+	service_file_resolve_forget(file);
+
+	return TRUE;
+}
+
+static void save_cache(s_event * event)
+{
+	h_sys_state *state;
+
+	assert(event->event_type == &EVENT_SYSTEM_CHANGE);
+	assert(event->data);
+
+	state = event->data;
+
+	/* the services of this boot are parsed by now */
+	if (*state == STATE_UP)
+		write_cache();
+}
+
+void service_file_cache_init(void)
+{
+	int i;
+
+	for (i = 0; i < CACHE_BUCKETS; i++)
+		initng_list_init(&cached[i]);
+
+	read_cache();
+
+	initng_command_register(&FORGET_SERVICE_FILE);
+	initng_event_hook_register(&EVENT_SYSTEM_CHANGE, &save_cache);
+}
+
+void service_file_cache_unload(void)
+{
+	s_cached *current, *safe = NULL;
+	int i;
+
+	initng_command_unregister(&FORGET_SERVICE_FILE);
+	initng_event_hook_unregister(&EVENT_SYSTEM_CHANGE, &save_cache);
+
+	write_cache();
+
+	for (i = 0; i < CACHE_BUCKETS; i++) {
+		initng_list_foreach_safe(current, safe, &cached[i], list)
+		    drop(current);
+	}
+
+	if (map)
+		munmap(map, map_len);
+	map = NULL;
+}
@@ -34,6 +34,7 @@
 #include <sys/socket.h>
 #include <string.h>
 #include <assert.h>
+#include <unistd.h>
 
 #ifdef GLOBAL_SOCKET
 #include <sys/un.h>
@@ -57,9 +58,15 @@ const struct initng_module initng_module = {
 	.unload = &module_unload
 };
 
-static int parse_new_service_file(s_event * event, char *file);
+static active_db_h *parse_new_service_file(const char *name, char *file,
+					   a_state_h * state);
 
 static void bp_handle_client(int fd);
+static void bp_handle_batch(int fd, bp_rep * rep);
+static void bp_handle_records(const char *buf, size_t len, bp_rep * rep,
+			      int all_kept);
+static void bp_handle(bp_rep * rep, bp_req_type request, const char *service,
+		      const char *a, const char *b, const char *c);
 static void bp_new_active(bp_rep * rep, const char *type,
 			  const char *service, const char *from_file);
 static void bp_set_variable(bp_rep * rep, const char *service,
@@ -71,6 +78,7 @@ static void bp_done(bp_rep * rep, const char *service);
 static void bp_abort(bp_rep * rep, const char *service);
 
 static void handle_killed(active_db_h * service, process_h * process);
+static void batch_plan(s_event * event);
 
 a_state_h PARSING = {
 	.name = "PARSING",
@@ -144,6 +152,18 @@ stype_h unset = {
 /* globals */
 struct stat sock_stat;
 
+/* parse processes running */
+static int parsers = 0;
+
+/* the file a parse keeps its iset and iexec in, see bp_keep() in bp.c */
+typedef struct {
+	process_h *process;
+	int fd;
+	list_t list;
+} batch_file_h;
+
+static list_t batch_files = LIST_HEAD_INIT(batch_files);
+
 #ifdef GLOBAL_SOCKET
 
 f_module_h bpf = {
@@ -167,32 +187,6 @@ static void bpf_handler(s_event * event)
 			close(bpf.fds);
 		break;
 
-	case IOW_ACTION_CHECK:
-		if (bpf.fds <= 2)
-			break;
-
-		/* This is a expensive test, but better safe then sorry */
-		if (!STILL_OPEN(bpf.fds)) {
-			D_("%i is not open anymore.\n", bpf.fds);
-			bpf.fds = -1;
-			break;
-		}
-
-		FD_SET(bpf.fds, data->readset);
-		data->added++;
-		break;
-
-	case IOW_ACTION_CALL:
-		if (!data->added || bpf.fds <= 2)
-			break;
-
-		if (!FD_ISSET(bpf.fds, data->readset))
-			break;
-
-		bp_incoming(&bpf, IOW_READ);
-		data->added--;
-		break;
-
 	case IOW_ACTION_DEBUG:
 		if (!data->debug_find_what ||
 		    strstr(__FILE__, data->debug_find_what)) {
@@ -212,12 +206,22 @@ static void bp_handle_client(int fd)
 {
 	bp_req req;
 	bp_rep rep;
+	int version;
 	int r;
 
 	S_;
 	memset(&req, 0, sizeof(bp_req));
 	memset(&rep, 0, sizeof(bp_rep));
 
+	/* both versions start with it */
+	r = recv(fd, &version, sizeof(int), MSG_PEEK);
+	if (r == (signed)sizeof(int) &&
+	    version == SERVICE_FILE_BATCH_VERSION) {
+		bp_handle_batch(fd, &rep);
+		SEND();
+		return;
+	}
+
 	/* use file descriptor, because fread hangs here? */
 	r = RSCV();
 
@@ -237,48 +241,195 @@ static void bp_handle_client(int fd)
 	}
 	D_("Got a request: ver: %i, type: %i\n", req.version, req.request);
 
+	bp_handle_req(&req, &rep);
+
+	/* send the reply */
+	SEND();
+}
+
+/* next string of a record, NULL if it runs past end */
+static const char *rec_string(const char **p, const char *end)
+{
+	const char *s = *p;
+	const char *nul = memchr(s, '\0', end - s);
+
+	if (!nul)
+		return NULL;
+
+	*p = nul + 1;
+	return s;
+}
+
+/*
+ * Handle the records of a version 2 batch in order. The reply is the
+ * one of the last record, the command that sent the batch, unless they
+ * are all kept ones. Those were kept by bp, and like in version 1 a
+ * failed one is only a warning, passed on in the message when the last
+ * record went fine. A failed NEW_ACTIVE ends the batch, what follows is
+ * for that service.
+ */
+static void bp_handle_records(const char *buf, size_t len, bp_rep * rep,
+			      int all_kept)
+{
+	const char *p, *end;
+	int warned = FALSE;
+
+	p = buf;
+	end = buf + len;
+	rep->success = TRUE;
+
+	while (p + sizeof(bp_rec) <= end) {
+		bp_rep one;
+		bp_rec rec;
+		const char *s[4] = { "", "", "", "" };
+		const char *next;
+		int i = 0;
+
+		memcpy(&rec, p, sizeof(bp_rec));
+		p += sizeof(bp_rec);
+		next = p + rec.len;
+
+		if (rec.len <= (size_t) (end - p)) {
+			for (; i < 4 && p < next; i++) {
+				if (!(s[i] = rec_string(&p, next)))
+					break;
+			}
+		}
+
+		if (i == 0 || (i < 4 && !s[i])) {
+			strcpy(rep->message, "Bad record");
+			rep->success = FALSE;
+			break;
+		}
+		p = next;
+
+		memset(&one, 0, sizeof(bp_rep));
+		bp_handle(&one, rec.request, s[0], s[1], s[2], s[3]);
+
+		/* the last one */
+		if (!all_kept && p + sizeof(bp_rec) > end) {
+			rep->success = one.success;
+			if (!one.success || !warned)
+				strcpy(rep->message, one.message);
+			break;
+		}
+
+		if (one.success)
+			continue;
+
+		W_("A kept request for %s failed: %s\n", s[0], one.message);
+		if (!warned) {
+			strcpy(rep->message, one.message);
+			warned = TRUE;
+		}
+
+		if (rec.request == NEW_ACTIVE) {
+			rep->success = FALSE;
+			break;
+		}
+	}
+}
+
+/*
+ * Handle a version 2 batch sent on fd.
+ */
+static void bp_handle_batch(int fd, bp_rep * rep)
+{
+	bp_batch batch;
+	char *buf;
+
+	if (recv(fd, &batch, sizeof(bp_batch), MSG_WAITALL) !=
+	    (signed)sizeof(bp_batch) || batch.len > BATCH_MAX) {
+		F_("Could not read incoming service_file batch. (fd %i)\n",
+		   fd);
+		strcpy(rep->message, "Unable to read request");
+		rep->success = FALSE;
+		return;
+	}
+
+	buf = initng_toolbox_calloc(1, batch.len + 1);
+	if (batch.len && recv(fd, buf, batch.len, MSG_WAITALL) !=
+	    (signed)batch.len) {
+		F_("Could not read incoming service_file batch. (fd %i)\n",
+		   fd);
+		strcpy(rep->message, "Unable to read request");
+		rep->success = FALSE;
+		free(buf);
+		return;
+	}
+
+	D_("Got a batch of %u bytes\n", batch.len);
+	bp_handle_records(buf, batch.len, rep, FALSE);
+	free(buf);
+}
+
+/*
+ * Handle a request, from a client on the socket or from the native
+ * parser.
+ */
+void bp_handle_req(bp_req * req, bp_rep * rep)
+{
 	/* check protocol version match */
-	if (req.version != SERVICE_FILE_VERSION) {
-		strcpy(rep.message, "Bad protocol version");
-		rep.success = FALSE;
-		SEND();
+	if (req->version != SERVICE_FILE_VERSION) {
+		strcpy(rep->message, "Bad protocol version");
+		rep->success = FALSE;
 		return;
 	}
 
+	switch (req->request) {
+	case NEW_ACTIVE:
+		bp_handle(rep, req->request, req->service,
+			  req->u.new_active.type,
+			  req->u.new_active.from_file, NULL);
+		break;
+
+	case SET_VARIABLE:
+		bp_handle(rep, req->request, req->service,
+			  req->u.set_variable.vartype,
+			  req->u.set_variable.varname,
+			  req->u.set_variable.value);
+		break;
+
+	case GET_VARIABLE:
+		bp_handle(rep, req->request, req->service,
+			  req->u.get_variable.vartype,
+			  req->u.get_variable.varname, NULL);
+		break;
+
+	default:
+		bp_handle(rep, req->request, req->service, NULL, NULL, NULL);
+		break;
+	}
+}
+
+/* handle a request, the strings after service depend on its type */
+static void bp_handle(bp_rep * rep, bp_req_type request, const char *service,
+		      const char *a, const char *b, const char *c)
+{
 	/* handle by request type */
-	switch (req.request) {
+	switch (request) {
 	case NEW_ACTIVE:
-		bp_new_active(&rep, req.u.new_active.type,
-			      req.service,
-			      req.u.new_active.from_file);
+		bp_new_active(rep, a, service, b);
 		break;
 
 	case SET_VARIABLE:
-		bp_set_variable(&rep, req.service,
-				req.u.set_variable.vartype,
-				req.u.set_variable.varname,
-				req.u.set_variable.value);
+		bp_set_variable(rep, service, a, b, c);
 		break;
 
 	case GET_VARIABLE:
-		bp_get_variable(&rep, req.service,
-				req.u.get_variable.vartype,
-				req.u.get_variable.varname);
+		bp_get_variable(rep, service, a, b);
 		break;
 
 	case DONE:
-		bp_done(&rep, req.service);
+		bp_done(rep, service);
 		break;
 
 	case ABORT:
-		bp_abort(&rep, req.service);
+		bp_abort(rep, service);
 
 	default:
 		break;
 	}
-
-	/* send the reply */
-	SEND();
 }
 
 static void bp_new_active(bp_rep * rep, const char *type,
@@ -302,8 +453,10 @@ static void bp_new_active(bp_rep * rep, const char *type,
 	/* look for existing */
 	new_active = initng_active_db_find_by_name(service);
 
-	/* check for duplet, not parsing */
-	if (new_active && new_active->current_state != &PARSING_FOR_START) {
+	/* check for duplet, not parsing, or parsing ahead of a start */
+	if (new_active && new_active->current_state != &PARSING_FOR_START &&
+	    !(new_active->current_state == &PARSING &&
+	      new_active->type == &unset)) {
 		strcpy(rep->message, "Duplet found.");
 		rep->success = FALSE;
 		return;
@@ -554,6 +707,14 @@ static void bp_done(bp_rep * rep, const char *service)
 		return;
 	}
 
+	/* keep what it got, for the next time, and get its deps going */
+	if (IS_MARK(active, &PARSING_FOR_START) || IS_MARK(active, &PARSING)) {
+		service_file_cache_store(active,
+					 initng_process_db_get(&parse, active)
+					 != NULL);
+		service_file_prefetch_deps(active);
+	}
+
 	/* must set to a DOWN state, to be able to start */
 	if (IS_MARK(active, &PARSING_FOR_START)) {
 		if (initng_common_mark_service(active, &REDY_FOR_START)) {
@@ -698,6 +859,9 @@ static int bp_open_socket()
 		return FALSE;
 	}
 
+	/* let the main loop call bp_incoming() */
+	initng_io_fd_register(&bpf);
+
 	return TRUE;
 }
 #endif
@@ -753,46 +917,176 @@ static void bp_closesock(void)
 
 	D_("bp_closesock %d\n", bpf.fds);
 
-	/* close socket and set to 0 */
+	/* stop polling, close socket and set to 0 */
+	initng_io_fd_unregister(&bpf);
 	close(bpf.fds);
 	bpf.fds = -1;
 }
 #endif
 
-static void handle_killed(active_db_h * service, process_h * process)
+/*
+ * The service file is parsed, status is its exit status.
+ */
+void service_file_parsed(active_db_h * service, int status)
 {
 	/* if process return code != 0, or the service was not
 	 * registered, set fail */
-	if (WEXITSTATUS(process->r_code) != 0 || service->type == &unset) {
+	if (status != 0 || service->type == &unset) {
 		initng_common_mark_service(service, &PARSE_FAIL);
-		initng_process_db_free(process);
 		return;
 	}
 
-	initng_process_db_free(process);
+	/* parsed ahead, it is started by what needs it */
+	if (IS_MARK(service, &NOT_RUNNING))
+		return;
+
 	initng_handler_start_service(service);
 }
 
-static void create_new_active(s_event * event)
+/*
+ * Open the file process keeps its batched records in. Nothing else can
+ * get at it, it is unlinked right away and the parse only gets the fd,
+ * as BATCH_FD.
+ */
+static void batch_open(process_h * process)
 {
-	char *r = NULL;
-	char *file;
-	char *name;
-	int found = 0;
+	char path[] = BATCH_TEMPLATE;
+	batch_file_h *batch;
+	int fd;
 
-	assert(event->event_type == &EVENT_NEW_ACTIVE);
+	if ((fd = mkstemp(path)) < 0) {
+		W_("Could not make a batch file for the parse: %s\n",
+		   strerror(errno));
+		return;
+	}
+	unlink(path);
+
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+	fcntl(fd, F_SETFL, O_APPEND);
+
+	batch = initng_toolbox_calloc(1, sizeof(batch_file_h));
+	batch->process = process;
+	batch->fd = fd;
+	initng_list_add(&batch->list, &batch_files);
+}
+
+static batch_file_h *batch_find(process_h * process)
+{
+	batch_file_h *current, *safe = NULL;
+
+	initng_list_foreach_safe(current, safe, &batch_files, list) {
+		if (current->process == process)
+			return current;
+	}
+
+	return NULL;
+}
+
+static void batch_close(batch_file_h * batch)
+{
+	initng_list_del(&batch->list);
+	close(batch->fd);
+	free(batch);
+}
+
+/* the parse gets its batch file on BATCH_FD */
+static void batch_plan(s_event * event)
+{
+	s_event_spawn_plan_data *data;
+	batch_file_h *batch;
+
+	assert(event->event_type == &EVENT_SPAWN_PLAN);
 	assert(event->data);
 
-	name = event->data;
+	data = event->data;
+
+	if (data->process->pt != &parse ||
+	    !(batch = batch_find(data->process)))
+		return;
+
+	initng_spawn_add_fd(data->plan, batch->fd, BATCH_FD);
+
+	/* the file is another one every parse */
+	data->plan->nocache = TRUE;
+}
+
+/*
+ * Handle what the parse of service kept and did not get to send, the
+ * isets after its last command that was not batched.
+ */
+static void batch_flush(process_h * process)
+{
+	batch_file_h *batch = batch_find(process);
+	struct stat st;
+	bp_rep rep;
+	char *buf;
+
+	if (!batch)
+		return;
+
+	if (fstat(batch->fd, &st) == 0 && st.st_size > 0 &&
+	    st.st_size <= BATCH_MAX) {
+		buf = initng_toolbox_calloc(1, st.st_size + 1);
+		if (pread(batch->fd, buf, st.st_size, 0) == st.st_size) {
+			D_("Handling %i kept bytes at exit\n",
+			   (int)st.st_size);
+			memset(&rep, 0, sizeof(bp_rep));
+			bp_handle_records(buf, st.st_size, &rep, TRUE);
+		}
+		free(buf);
+	}
+
+	batch_close(batch);
+}
+
+static void handle_killed(active_db_h * service, process_h * process)
+{
+	int status = WEXITSTATUS(process->r_code);
+
+	/* what bp kept, if it did not get to send it */
+	batch_flush(process);
+
+	initng_process_db_free(process);
+	parsers--;
+	service_file_parsed(service, status);
+
+	/* there is room for one more */
+	service_file_prefetch_run();
+}
 
-	/* printf("create_new_active(%s);\n", name); */
+/*
+ * Find the file of service name, and parse it. It is started when it
+ * is parsed if for_start, else only left down. Returns the new
+ * service, or NULL if there is no file for it.
+ */
+active_db_h *service_file_load(const char *name, int for_start)
+{
+	active_db_h *found;
+	a_state_h *state = for_start ? &PARSING_FOR_START : &PARSING;
+	const char *known;
+	char *r = NULL;
+	char *file;
+
+	/* printf("service_file_load(%s);\n", name); */
 	/* printf("service \"%s\" ", name); */
 
 	/* "this" and "any" aren't allowed service names */
 	{
 		const char *bname = initng_string_basename(name);
 		if (strcmp(bname, "this") == 0 || strcmp(bname, "any") == 0)
-			return;
+			return NULL;
+	}
+
+	/* found, or not, before */
+	if (service_file_resolve_find(name, &known)) {
+		if (!known)
+			return NULL;
+
+		file = initng_toolbox_strdup(known);
+		found = parse_new_service_file(name, file, state);
+		free(file);
+		if (found)
+			return found;
 	}
 
 	file = malloc(sizeof(INITNG_ROOT) + sizeof("/this") + strlen(name) + 2);
@@ -807,65 +1101,82 @@ static void create_new_active(s_event * event)
 	strcpy(file, INITNG_ROOT "/");
 	strcat(file, name);
 
-	if (!(found = parse_new_service_file(event, file))) {
+	if (!(found = parse_new_service_file(name, file, state))) {
 		r = strrchr(file, '/');
 
 		/* Add "this" and see if there is better luck */
 		strcat(file, "/this");
-		if (!(found = parse_new_service_file(event, file)) && r) {
+		if (!(found = parse_new_service_file(name, file, state)) && r) {
 			r[0] = '\0';
 
 			/* Add "any" */
 			strcat(file, "/any");
-			found = parse_new_service_file(event, file);
+			found = parse_new_service_file(name, file, state);
 		}
 	}
 
-	if (found)
-		event->status = HANDLED;
-
+	service_file_resolve_add(name, found ? file : NULL);
 	free(file);
+	return found;
 }
 
-static int parse_new_service_file(s_event * event, char *file)
+/* parse processes running */
+int service_file_parsers(void)
+{
+	return parsers;
+}
+
+static void create_new_active(s_event * event)
+{
+	assert(event->event_type == &EVENT_NEW_ACTIVE);
+	assert(event->data);
+
+	if ((event->ret = service_file_load(event->data, TRUE)))
+		event->status = HANDLED;
+}
+
+static active_db_h *parse_new_service_file(const char *name, char *file,
+					   a_state_h * state)
 {
-	char *name;
 	active_db_h *new_active;
 	process_h *process;
 	pipe_h *current_pipe;
 	struct stat fstat;
 
-	name = event->data;
-
 	/* Take stat on file */
 	if (stat(file, &fstat) != 0)
-		return FALSE;
+		return NULL;
 
 	/* Is a regular file */
 	if (!S_ISREG(fstat.st_mode))
-		return FALSE;
+		return NULL;
 
 	if (!(fstat.st_mode & S_IXUSR)) {
 		F_("File \"%s\" can not be executed!\n", file);
-		return FALSE;
+		return NULL;
 	}
 
 	/* create new service */
 	new_active = initng_active_db_new(name);
 	if (!new_active) {
-		return FALSE;
+		return NULL;
 	}
 
 	/* set type */
-	new_active->current_state = &PARSING_FOR_START;
+	new_active->current_state = state;
 	new_active->type = &unset;
 
 	/* register it */
 	if (!initng_active_db_register(new_active)) {
 		initng_active_db_free(new_active);
-		return FALSE;
+		return NULL;
 	}
 
+	/* most files only declare the service, no need to run them */
+	if (service_file_cache_apply(new_active, file, &fstat) ||
+	    service_file_native(new_active, file))
+		return new_active;
+
 	/* create the process */
 	process = initng_process_db_new(&parse);
 
@@ -881,20 +1192,27 @@ static int parse_new_service_file(s_event * event, char *file)
 	}
 
 	/* start parse process */
-	if (initng_fork(new_active, process) == 0) {
+	{
 		char *new_argv[3];
 
 		new_argv[0] = file;
 		new_argv[1] = (char *)"internal_setup";
 		new_argv[2] = NULL;
 
-		execve(new_argv[0], new_argv, initng_env_new(new_active));
-		_exit(10);
+		batch_open(process);
+		if (initng_spawn(new_active, process, new_argv) > 0) {
+			parsers++;
+		} else {
+			batch_file_h *batch = batch_find(process);
+
+			if (batch)
+				batch_close(batch);
+			initng_common_mark_service(new_active, &PARSE_FAIL);
+		}
 	}
 
 	/* return the newly created */
-	event->ret = new_active;
-	return TRUE;
+	return new_active;
 }
 
 static void get_pipe(s_event * event)
@@ -941,10 +1259,14 @@ int module_init(void)
 #endif
 	initng_event_hook_register(&EVENT_NEW_ACTIVE, &create_new_active);
 	initng_event_hook_register(&EVENT_PIPE_WATCHER, &get_pipe);
+	initng_event_hook_register(&EVENT_SPAWN_PLAN, &batch_plan);
 	initng_active_state_register(&REDY_FOR_START);
 	initng_active_state_register(&NOT_RUNNING);
 	initng_active_state_register(&PARSING);
 	initng_active_state_register(&PARSE_FAIL);
+	service_file_cache_init();
+	service_file_resolve_init();
+	service_file_prefetch_init();
 
 #ifdef GLOBAL_SOCKET
 	/* do the first socket directly */
@@ -956,6 +1278,8 @@ int module_init(void)
 
 void module_unload(void)
 {
+	batch_file_h *current, *safe = NULL;
+
 #ifdef GLOBAL_SOCKET
 	/* close open sockets */
 	bp_closesock();
@@ -969,8 +1293,14 @@ void module_unload(void)
 #endif
 	initng_event_hook_unregister(&EVENT_NEW_ACTIVE, &create_new_active);
 	initng_event_hook_unregister(&EVENT_PIPE_WATCHER, &get_pipe);
+	initng_event_hook_unregister(&EVENT_SPAWN_PLAN, &batch_plan);
+	initng_list_foreach_safe(current, safe, &batch_files, list)
+		batch_close(current);
 	initng_active_state_unregister(&REDY_FOR_START);
 	initng_active_state_unregister(&NOT_RUNNING);
 	initng_active_state_unregister(&PARSING);
 	initng_active_state_unregister(&PARSE_FAIL);
+	service_file_cache_unload();
+	service_file_resolve_unload();
+	service_file_prefetch_unload();
 }
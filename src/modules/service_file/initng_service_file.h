@@ -20,10 +20,18 @@
 #ifndef SERVICE_FILE_H
 #define SERVICE_FILE_H
 
+#include <sys/stat.h>
+#include <stdint.h>
 
 #define SERVICE_FILE_VERSION 1
+#define SERVICE_FILE_BATCH_VERSION 2
 #define SOCKET_PATH CTLDIR "/bp"
 
+/* where iset and iexec are kept until sent, a file the parse gets as fd */
+#define BATCH_FD 4
+#define BATCH_TEMPLATE CTLDIR "/bp-batch.XXXXXX"
+#define BATCH_MAX (1024 * 1024)
+
 /* incoming type */
 typedef enum {
 	UNSET_INVALID = 0,
@@ -65,6 +73,25 @@ typedef struct {
 } bp_req;
 
 
+/*
+ * Version 2 sends any number of records on one connection, and gets one
+ * bp_rep back. A batch starts with a bp_batch, the version where a v1
+ * bp_req has it, and then len bytes of records. Every record is a
+ * bp_rec followed by len bytes of '\0' terminated strings: the service,
+ * and then type and from_file for NEW_ACTIVE, vartype, varname and
+ * value for SET_VARIABLE, or vartype and varname for GET_VARIABLE.
+ */
+typedef struct {
+	int version;			/* SERVICE_FILE_BATCH_VERSION */
+	uint32_t len;			/* of the records */
+} bp_batch;
+
+typedef struct {
+	uint32_t len;			/* of the strings */
+	uint32_t request;		/* bp_req_type */
+} bp_rec;
+
+
 #define BP_REP_MAXLEN 1024
 
 typedef struct {
@@ -72,4 +99,33 @@ typedef struct {
 	char message[BP_REP_MAXLEN + 1];	/* used for transporting a string to the client */
 } bp_rep;
 
+/* in the module */
+void bp_handle_req(bp_req * req, bp_rep * rep);
+void service_file_parsed(active_db_h * service, int status);
+active_db_h *service_file_load(const char *name, int for_start);
+int service_file_parsers(void);
+
+/* native.c */
+int service_file_native(active_db_h * service, const char *file);
+
+/* cache.c */
+int service_file_cache_apply(active_db_h * service, const char *file,
+			     struct stat *st);
+void service_file_cache_store(active_db_h * service, int script);
+void service_file_cache_init(void);
+void service_file_cache_unload(void);
+
+/* resolve.c */
+int service_file_resolve_find(const char *name, const char **file);
+void service_file_resolve_add(const char *name, const char *file);
+void service_file_resolve_forget(const char *file);
+void service_file_resolve_init(void);
+void service_file_resolve_unload(void);
+
+/* prefetch.c */
+void service_file_prefetch_deps(active_db_h * service);
+void service_file_prefetch_run(void);
+void service_file_prefetch_init(void);
+void service_file_prefetch_unload(void);
+
 #endif
@@ -0,0 +1,454 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <assert.h>
+
+#include "initng_service_file.h"
+
+/*
+ * The native parser.
+ *
+ * Most service files are a setup() that only does iregister, iset,
+ * iexec and idone with plain words. Running them costs a fork and exec
+ * of the shell, and one more with a socket round trip for every line.
+ * Files like that are read here instead, and the same requests are
+ * handled right away. As soon as anything needs a shell, like a
+ * variable, a pipe or an if, the file is left to the script path.
+ */
+
+#define MAX_WORDS 128
+#define LINE_LEN 2048
+
+/* these mean something to sh, outside quotes */
+#define SHELL_CHARS "$`\\;|&<>(){}*?[]~"
+
+typedef struct {
+	char *buf;
+	char *argv[MAX_WORDS + 1];
+	int argc;
+	int or_exit;		/* ends with "|| exit" */
+} s_line;
+
+static char *trim(char *s)
+{
+	char *end;
+
+	while (isspace((unsigned char)*s))
+		s++;
+
+	end = s + strlen(s);
+	while (end > s && isspace((unsigned char)end[-1]))
+		*--end = '\0';
+
+	return s;
+}
+
+/*
+ * Split line in words in place, like sh would. Returns FALSE if it
+ * takes a shell to do that.
+ */
+static int split(char *line, s_line * out)
+{
+	char *r = line;
+	char *w = line;
+	char *or;
+
+	/* only a "|| exit" at the end is understood */
+	or = strstr(line, "||");
+	if (or && strcmp(trim(or + 2), "exit") == 0) {
+		*or = '\0';
+		out->or_exit = TRUE;
+	}
+
+	for (;;) {
+		while (*r == ' ' || *r == '\t')
+			r++;
+
+		if (!*r || *r == '#')
+			break;
+
+		if (out->argc == MAX_WORDS)
+			return FALSE;
+		out->argv[out->argc++] = w;
+
+		while (*r && *r != ' ' && *r != '\t') {
+			if (*r == '\'') {
+				for (r++; *r && *r != '\''; )
+					*w++ = *r++;
+				if (!*r++)
+					return FALSE;
+				continue;
+			}
+
+			if (*r == '"') {
+				for (r++; *r && *r != '"'; ) {
+					if (strchr("$`\\", *r))
+						return FALSE;
+					*w++ = *r++;
+				}
+				if (!*r++)
+					return FALSE;
+				continue;
+			}
+
+			if (strchr(SHELL_CHARS, *r))
+				return FALSE;
+
+			*w++ = *r++;
+		}
+
+		if (*r)
+			r++;
+		*w++ = '\0';
+	}
+
+	out->argv[out->argc] = NULL;
+	return TRUE;
+}
+
+/*
+ * Is line a "name()" header, with or without the "{"? Sets brace if
+ * the "{" is there.
+ */
+static int func_header(char *line, char **name, int *brace)
+{
+	char *p = line;
+
+	while (isalnum((unsigned char)*p) || *p == '_')
+		p++;
+
+	if (p == line)
+		return FALSE;
+
+	*name = line;
+	if (*p == ' ' || *p == '\t')
+		*p++ = '\0';
+	p = trim(p);
+
+	if (strncmp(p, "()", 2) != 0)
+		return FALSE;
+	*p = '\0';
+	p = trim(p + 2);
+
+	*brace = (*p == '{');
+	if (*brace)
+		p++;
+
+	/* a body on the same line needs the shell */
+	return *p == '\0';
+}
+
+/*
+ * Read the lines of setup() from file. Returns the number of lines,
+ * or -1 if the file is not only function definitions, or setup() not
+ * only plain lines.
+ */
+static int read_setup(FILE * f, s_line ** lines)
+{
+	char buf[LINE_LEN];
+	int len = 0;
+	int in_func = FALSE;
+	int in_setup = FALSE;
+	int want_brace = FALSE;
+	int found = FALSE;
+	int lineno = 0;
+
+	*lines = NULL;
+
+	while (fgets(buf, LINE_LEN, f)) {
+		char *line;
+		char *name;
+
+		/* a line too long to read at once */
+		if (!strchr(buf, '\n') && !feof(f))
+			goto shell;
+
+		line = trim(buf);
+		lineno++;
+
+		/* the script must be run by runiscript */
+		if (lineno == 1) {
+			if (strncmp(line, "#!", 2) != 0 ||
+			    strcmp(initng_string_basename(trim(line + 2)),
+				   "runiscript") != 0)
+				goto shell;
+			continue;
+		}
+
+		if (want_brace) {
+			if (!*line || *line == '#')
+				continue;
+			if (strcmp(line, "{") != 0)
+				goto shell;
+			want_brace = FALSE;
+			continue;
+		}
+
+		/* a body ends with a "}" first on its line */
+		if (in_func) {
+			if (buf[0] == '}' && !*trim(buf + 1)) {
+				in_func = FALSE;
+				in_setup = FALSE;
+				continue;
+			}
+
+			if (!in_setup || !*line || *line == '#')
+				continue;
+
+			*lines = initng_toolbox_realloc(*lines, (len + 1) *
+							sizeof(s_line));
+			memset(&(*lines)[len], 0, sizeof(s_line));
+			(*lines)[len].buf = initng_toolbox_strdup(line);
+			len++;
+
+			if (!split((*lines)[len - 1].buf, &(*lines)[len - 1]))
+				goto shell;
+			continue;
+		}
+
+		/* outside functions only comments are left alone */
+		if (!*line || *line == '#')
+			continue;
+
+		if (!func_header(line, &name, &want_brace))
+			goto shell;
+
+		want_brace = !want_brace;
+		in_func = TRUE;
+
+		if (strcmp(name, "setup") == 0) {
+			if (found)
+				goto shell;
+			in_setup = found = TRUE;
+		}
+	}
+
+	if (!found || in_func || want_brace)
+		goto shell;
+	return len;
+
+shell:
+	return -1 - len;
+}
+
+static void free_lines(s_line * lines, int len)
+{
+	int i;
+
+	for (i = 0; i < len; i++)
+		free(lines[i].buf);
+	free(lines);
+}
+
+/*
+ * Fill req from the words of a line, the way bp does it. Returns
+ * FALSE if the words are not right for the command.
+ */
+static int make_req(bp_req * req, s_line * line, const char *file)
+{
+	char **argv = line->argv;
+	int argc = line->argc - 1;
+	const char *cmd = argv[0];
+
+	if (strcmp(cmd, "iregister") == 0) {
+		if (argc != 1)
+			return FALSE;
+
+		req->request = NEW_ACTIVE;
+		strncpy(req->u.new_active.type, argv[1], 40);
+		strncpy(req->u.new_active.from_file, file, 100);
+		return TRUE;
+	}
+
+	if (strcmp(cmd, "idone") == 0) {
+		req->request = DONE;
+		return TRUE;
+	}
+
+	if (strcmp(cmd, "iabort") == 0) {
+		req->request = ABORT;
+		return TRUE;
+	}
+
+	req->request = SET_VARIABLE;
+
+	if (strcmp(cmd, "iexec") == 0) {
+		const char *what = argv[1];
+		char *value = req->u.set_variable.value;
+
+		if (argc != 1 && (argc != 3 || strcmp(argv[2], "=") != 0))
+			return FALSE;
+
+		if (argc == 3)
+			what = argv[3];
+
+		/* "/etc/initng/file internal_start" */
+		if (argc == 3 && what[0] == '/')
+			strncpy(value, what, 1024);
+		else
+			snprintf(value, 1025, "%s internal_%s", file, what);
+
+		strncpy(req->u.set_variable.vartype, "exec", 100);
+		strncpy(req->u.set_variable.varname, argv[1], 100);
+		return TRUE;
+	}
+
+	if (strcmp(cmd, "iset") == 0) {
+		if (argc < 1)
+			return FALSE;
+
+		strncpy(req->u.set_variable.vartype, argv[1], 100);
+
+		/* "iset forks", "iset start forks" */
+		if (argc < 3) {
+			if (argc == 2)
+				strncpy(req->u.set_variable.varname, argv[2],
+					100);
+			return TRUE;
+		}
+
+		/* "iset need = a b", "iset exec start = /bin/foo" */
+		if (strcmp(argv[2], "=") == 0)
+			return TRUE;
+		if (argc >= 4 && strcmp(argv[3], "=") == 0) {
+			strncpy(req->u.set_variable.varname, argv[2], 100);
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+static int send_req(bp_req * req, s_line * line, const char *service)
+{
+	bp_rep rep;
+	int i;
+
+	memset(&rep, 0, sizeof(bp_rep));
+	req->version = SERVICE_FILE_VERSION;
+	bp_handle_req(req, &rep);
+
+	/* tell the same as bp would */
+	if (strlen(rep.message) > 1) {
+		char *words = NULL;
+
+		for (i = 1; line->argv[i]; i++)
+			initng_string_mprintf(&words, " %s", line->argv[i]);
+
+		W_("%s (%s) :%s  \"%s\"\n", line->argv[0], service,
+		   words ? words : "", rep.message);
+		free(words);
+	}
+
+	return rep.success;
+}
+
+/*
+ * Run the requests of a line, an iset sends one request for every
+ * value.
+ */
+static int run_line(s_line * line, active_db_h * service, const char *file)
+{
+	bp_req req;
+	int i;
+
+	memset(&req, 0, sizeof(bp_req));
+	strncpy(req.service, service->name, 100);
+
+	if (!make_req(&req, line, file))
+		return FALSE;
+
+	if (strcmp(line->argv[0], "iset") != 0 || line->argc < 4)
+		return send_req(&req, line, service->name);
+
+	/* the values follow the "=" */
+	for (i = 2; strcmp(line->argv[i], "=") != 0; i++) ;
+
+	for (i++; line->argv[i]; i++) {
+		strncpy(req.u.set_variable.value, line->argv[i], 1024);
+		if (!send_req(&req, line, service->name))
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+/*
+ * Parse file for service without a shell. Returns FALSE if it needs
+ * one, and nothing is done then.
+ */
+int service_file_native(active_db_h * service, const char *file)
+{
+	s_line *lines;
+	const char *ext;
+	FILE *f;
+	int len;
+	int status = 0;
+	int i;
+
+	assert(service);
+	assert(file);
+
+	/* a file with a wrapper of its own, is left to that */
+	ext = strrchr(initng_string_basename(file), '.');
+	if (ext && ext != initng_string_basename(file))
+		return FALSE;
+
+	f = fopen(file, "r");
+	if (!f)
+		return FALSE;
+
+	len = read_setup(f, &lines);
+	fclose(f);
+
+	if (len < 0) {
+		free_lines(lines, -1 - len);
+		return FALSE;
+	}
+
+	/* only the commands bp knows, with the right words */
+	for (i = 0; i < len; i++) {
+		bp_req req;
+
+		memset(&req, 0, sizeof(bp_req));
+		if (!make_req(&req, &lines[i], file)) {
+			free_lines(lines, len);
+			return FALSE;
+		}
+	}
+
+	D_("Parsing %s natively.\n", file);
+
+	/* the exit status of sh, is that of the last command */
+	for (i = 0; i < len; i++) {
+		status = !run_line(&lines[i], service, file);
+		if (status && lines[i].or_exit)
+			break;
+	}
+
+	free_lines(lines, len);
+	service_file_parsed(service, status);
+	return TRUE;
+}
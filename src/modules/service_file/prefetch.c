@@ -0,0 +1,144 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>		/* sysconf() */
+#include <assert.h>
+
+#include "initng_service_file.h"
+
+/*
+ * Parsing ahead.
+ *
+ * A service only finds its deps when it is parsed and started, so the
+ * services of a runlevel are found one parse after the other, along
+ * every chain of deps. Instead, as soon as a service is parsed, the
+ * deps it needs that are not loaded yet are queued, and parsed without
+ * starting them, a few shell parses at a time. The one that needs them
+ * starts them when it gets to it, and they are most likely parsed by
+ * then.
+ *
+ * The queue is run from a timer, so the parses started from idone
+ * do not nest.
+ */
+
+/* shell parses at once, cpus + 1 by default, parse_workers=N to set */
+static int workers = 0;
+
+static list_t queue = LIST_HEAD_INIT(queue);
+static s_timer kick;
+
+typedef struct {
+	char *name;
+	list_t list;
+} s_wanted;
+
+static void run_queue(s_timer * timer)
+{
+	s_wanted *current;
+
+	(void)timer;
+
+	while (!initng_list_isempty(&queue) &&
+	       service_file_parsers() < workers) {
+		current = initng_list_entry(queue.next, s_wanted, list);
+		initng_list_del(&current->list);
+
+		/* might have been loaded since */
+		if (!initng_active_db_find_by_name(current->name)) {
+			D_("Parsing %s ahead.\n", current->name);
+			service_file_load(current->name, FALSE);
+		}
+
+		free(current->name);
+		free(current);
+	}
+}
+
+/*
+ * Queue the deps service needs, that are not loaded yet.
+ */
+void service_file_prefetch_deps(active_db_h * service)
+{
+	s_wanted *current;
+	s_dep *edge;
+
+	assert(service);
+
+	initng_depend_graph_sync();
+
+	while_depend_edges(edge, service) {
+		if (edge->to ||
+		    (edge->type != DEP_REQUIRE && edge->type != DEP_NEED))
+			continue;
+
+		/* once is enough */
+		initng_list_foreach(current, &queue, list) {
+			if (strcmp(current->name, edge->name) == 0)
+				break;
+		}
+		if (&current->list != &queue)
+			continue;
+
+		current = initng_toolbox_calloc(1, sizeof(s_wanted));
+		current->name = initng_toolbox_strdup(edge->name);
+		initng_list_add_tail(&current->list, &queue);
+	}
+
+	service_file_prefetch_run();
+}
+
+/* run the queue soon, a parse might have finished */
+void service_file_prefetch_run(void)
+{
+	if (!initng_list_isempty(&queue) && !initng_timer_is_armed(&kick))
+		initng_timer_arm(&kick, 0);
+}
+
+void service_file_prefetch_init(void)
+{
+	int i;
+
+	initng_timer_init(&kick, &run_queue);
+
+	workers = sysconf(_SC_NPROCESSORS_ONLN) + 1;
+	for (i = 0; g.Argv[i]; i++) {
+		if (strncmp(g.Argv[i], "parse_workers=", 14) == 0)
+			workers = atoi(&g.Argv[i][14]);
+	}
+
+	if (workers < 1)
+		workers = 1;
+}
+
+void service_file_prefetch_unload(void)
+{
+	s_wanted *current, *safe = NULL;
+
+	initng_timer_cancel(&kick);
+
+	initng_list_foreach_safe(current, safe, &queue, list) {
+		initng_list_del(&current->list);
+		free(current->name);
+		free(current);
+	}
+}
@@ -0,0 +1,201 @@
+/*
+ * Initng, a next generation sysvinit replacement.
+ * Copyright (C) 2006 Jimmy Wennlund <jimmy.wennlund@gmail.com>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <initng.h>
+#include <initng-paths.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "initng_service_file.h"
+
+/*
+ * The resolve cache.
+ *
+ * Finding the file of a service takes up to three stats, and names that
+ * have no file, like most USE deps, are looked for again every time
+ * they are asked for. What a name resolved to, a file or nothing, is
+ * kept here. It is only used while fmon watches INITNG_ROOT and tells
+ * about every change there with the forget_service_file command, else
+ * a new file would never be found.
+ */
+
+#define RESOLVE_BUCKETS	64
+
+typedef struct {
+	char *name;
+	hash_t hash;
+	char *file;		/* NULL if there is none */
+	list_t list;
+} s_resolved;
+
+static list_t resolved[RESOLVE_BUCKETS];
+static int watched = FALSE;
+
+static void drop_all(void);
+
+/*
+ * Ask fmon if it watches the service files. The cache is dropped when
+ * it stops, whatever happens after that is unknown.
+ */
+static int is_watched(void)
+{
+	s_command *cmd = initng_command_find_by_command_string(
+					(char *)"service_files_watched");
+	int now = FALSE;
+
+	if (cmd && cmd->u.int_command_call)
+		now = (*cmd->u.int_command_call)(NULL);
+
+	if (watched && !now)
+		drop_all();
+
+	watched = now;
+	return now;
+}
+
+static s_resolved *find(const char *name, hash_t hash)
+{
+	s_resolved *current;
+
+	initng_list_foreach(current, &resolved[hash % RESOLVE_BUCKETS], list) {
+		if (current->hash == hash && strcmp(current->name, name) == 0)
+			return current;
+	}
+
+	return NULL;
+}
+
+static void drop(s_resolved * r)
+{
+	initng_list_del(&r->list);
+	free(r->name);
+	free(r->file);
+	free(r);
+}
+
+static void drop_all(void)
+{
+	s_resolved *current, *safe = NULL;
+	int i;
+
+	for (i = 0; i < RESOLVE_BUCKETS; i++) {
+		initng_list_foreach_safe(current, safe, &resolved[i], list)
+		    drop(current);
+	}
+}
+
+/*
+ * Look name up. Returns TRUE if it is known, and sets file to the file
+ * it was found in, or NULL if it has none.
+ */
+int service_file_resolve_find(const char *name, const char **file)
+{
+	s_resolved *r;
+
+	if (!is_watched())
+		return FALSE;
+
+	if (!(r = find(name, initng_hash_str(name))))
+		return FALSE;
+
+	*file = r->file;
+	return TRUE;
+}
+
+/* Remember that name is in file, or nowhere if file is NULL */
+void service_file_resolve_add(const char *name, const char *file)
+{
+	s_resolved *r;
+	hash_t hash;
+
+	if (!is_watched())
+		return;
+
+	hash = initng_hash_str(name);
+	if ((r = find(name, hash)))
+		drop(r);
+
+	r = initng_toolbox_calloc(1, sizeof(s_resolved));
+	r->name = initng_toolbox_strdup(name);
+	r->hash = hash;
+	r->file = file ? initng_toolbox_strdup(file) : NULL;
+	initng_list_add(&r->list, &resolved[hash % RESOLVE_BUCKETS]);
+}
+
+/* does a change to path, under INITNG_ROOT, change what name resolves to */
+static int affects(const char *name, const char *path)
+{
+	size_t len = strlen(path);
+	const char *slash = strrchr(name, '/');
+	size_t dir = slash ? (size_t) (slash - name) + 1 : 0;
+
+	/* the file itself, or a dir it is in */
+	if (strncmp(name, path, len) == 0 &&
+	    (name[len] == '\0' || name[len] == '/'))
+		return TRUE;
+
+	/* its "this" */
+	if (strncmp(path, name, strlen(name)) == 0 &&
+	    strcmp(&path[strlen(name)], "/this") == 0)
+		return TRUE;
+
+	/* the "any" of its dir */
+	return (strncmp(path, name, dir) == 0 &&
+		strcmp(&path[dir], "any") == 0);
+}
+
+/*
+ * A file or dir changed, forget the names it might resolve differently.
+ * NULL forgets all.
+ */
+void service_file_resolve_forget(const char *file)
+{
+	s_resolved *current, *safe = NULL;
+	const char *path;
+	int i;
+
+	if (!file || strncmp(file, INITNG_ROOT "/", sizeof(INITNG_ROOT)) != 0) {
+		drop_all();
+		return;
+	}
+
+	path = file + sizeof(INITNG_ROOT);
+
+	for (i = 0; i < RESOLVE_BUCKETS; i++) {
+		initng_list_foreach_safe(current, safe, &resolved[i], list) {
+			if (affects(current->name, path))
+				drop(current);
+		}
+	}
+}
+
+void service_file_resolve_init(void)
+{
+	int i;
+
+	for (i = 0; i < RESOLVE_BUCKETS; i++)
+		initng_list_init(&resolved[i]);
+}
+
+void service_file_resolve_unload(void)
+{
+	drop_all();
+}
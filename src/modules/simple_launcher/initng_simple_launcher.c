@@ -160,25 +160,13 @@ static int simple_exec_fork(process_h * process_to_exec, active_db_h * s,
 	/* This is the real service kicker */
 	pid_t pid_fork;		/* pid got from fork() */
 
-	pid_fork = initng_fork(s, process_to_exec);
-	if (pid_fork == 0) {
-		/* run g.AFTER_FORK from other modules */
-		initng_fork_aforkhooks(s, process_to_exec);
-
 #ifdef DEBUG
-		D_("FROM_FORK simple_exec(%i,%s, ...);\n", argc, argv[0]);
-		/*D_argv("simple_exec: ", argv); */
+	D_("simple_exec(%i,%s, ...);\n", argc, argv[0]);
+	/*D_argv("simple_exec: ", argv); */
 #endif
 
-		/* FINALLY EXECUTE *//* execve replaces the running process */
-		execve(argv[0], argv, initng_env_new(s));
-
-		/* Will never get here if execve succeeded */
-		F_("ERROR!\n");
-		F_("Can't execute source %s!\n", argv[0]);
-
-		_exit(1);
-	}
+	/* the modules plan the child, and it is spawned */
+	pid_fork = initng_spawn(s, process_to_exec, argv);
 
 	/* save pid of fork */
 	D_("FROM_FORK Forkstarted pid %i.\n", pid_fork);
@@ -186,7 +174,7 @@ static int simple_exec_fork(process_h * process_to_exec, active_db_h * s,
 	if (pid_fork > 0)
 		return TRUE;
 
-	process_to_exec->pid = 0;
+	initng_process_db_set_pid(process_to_exec, NULL, 0);
 	return FALSE;
 	/* if to test want to lock this up until fork is done ...
 	 * waitpid(pid_fork,0,0); */
@@ -62,6 +62,7 @@ static char *cmd_get_depends_on(char *arg);
 static char *cmd_get_depends_on_deep(char *arg);
 static char *cmd_get_depends_off(char *arg);
 static char *cmd_get_depends_off_deep(char *arg);
+static char *cmd_get_dep_cycles(char *arg);
 static int cmd_new_init(char *arg);
 static int cmd_run(char *arg);
 static int cmd_signal(char *arg);
@@ -228,6 +229,16 @@ s_command DEPENDS_OFF_DEEP = {
 	.description = "Print what dependencies that are depending on me deep"
 };
 
+s_command DEP_CYCLES = {
+	.id = 'C',
+	.long_id = "dep_cycles",
+	.com_type = STRING_COMMAND,
+	.opt_visible = ADVANCHED_COMMAND,
+	.opt_type = NO_OPT,
+	.u = {(void *)&cmd_get_dep_cycles},
+	.description = "Print circular dependencies"
+};
+
 s_command NEW_INIT = {
 	.id = 'E',
 	.long_id = "new_init",
@@ -572,6 +583,48 @@ static char *cmd_get_depends_off_deep(char *arg)
 	return string;
 }
 
+static char *cmd_get_dep_cycles(char *arg)
+{
+	char *string = NULL;
+	active_db_h *current = NULL;
+	s_dep *edge;
+
+	(void)arg;
+
+	initng_depend_graph_sync();
+
+	initng_string_mprintf(&string, "Services in a circular dependency, "
+			      "that can't start:\n");
+
+	while_active_db(current) {
+		if (!current->deps_cycle)
+			continue;
+
+		initng_string_mprintf(&string, "  %s ->", current->name);
+		while_depend_edges(edge, current) {
+			if (DEP_IS_DEPEND(edge) && edge->to &&
+			    edge->to->deps_cycle)
+				initng_string_mprintf(&string, " %s",
+						      edge->name);
+		}
+		initng_string_mprintf(&string, "\n");
+	}
+
+	initng_string_mprintf(&string, "Uses ignored to break a circular "
+			      "dependency:\n");
+
+	while_active_db(current) {
+		while_depend_edges(edge, current) {
+			if (edge->broken)
+				initng_string_mprintf(&string, "  %s uses %s\n",
+						      current->name,
+						      edge->name);
+		}
+	}
+
+	return string;
+}
+
 static int cmd_new_init(char *arg)
 {
 	char *new_i;
@@ -651,6 +704,7 @@ int module_init(void)
 	initng_command_register(&DEPENDS_ON_DEEP);
 	initng_command_register(&DEPENDS_OFF);
 	initng_command_register(&DEPENDS_OFF_DEEP);
+	initng_command_register(&DEP_CYCLES);
 	initng_command_register(&NEW_INIT);
 	initng_command_register(&RUN);
 	return TRUE;
@@ -676,6 +730,7 @@ void module_unload(void)
 	initng_command_unregister(&DEPENDS_ON_DEEP);
 	initng_command_unregister(&DEPENDS_OFF);
 	initng_command_unregister(&DEPENDS_OFF_DEEP);
+	initng_command_unregister(&DEP_CYCLES);
 	initng_command_unregister(&NEW_INIT);
 	initng_command_unregister(&RUN);
 }
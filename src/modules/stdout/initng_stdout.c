@@ -71,7 +71,7 @@ s_entry STDIN = {
 
 static void setup_output(s_event * event)
 {
-	s_event_after_fork_data *data;
+	s_event_spawn_plan_data *data;
 
 	/* string containing the filename of output */
 	const char *s_stdout = NULL;
@@ -79,13 +79,7 @@ static void setup_output(s_event * event)
 	const char *s_stdall = NULL;
 	const char *s_stdin = NULL;
 
-	/* file descriptors */
-	int fd_stdout = -1;
-	int fd_stderr = -1;
-	int fd_stdall = -1;
-	int fd_stdin = -1;
-
-	assert(event->event_type == &EVENT_AFTER_FORK);
+	assert(event->event_type == &EVENT_SPAWN_PLAN);
 	assert(event->data);
 
 	data = event->data;
@@ -115,69 +109,37 @@ static void setup_output(s_event * event)
 		s_stderr = NULL;
 	}
 
-	/* if stdall string is set */
+	/*
+	 * The child opens them, a file that does not open is logged by
+	 * initng, and that output goes to initng as without it.
+	 */
 	if (s_stdall) {
 		/* output all to this */
-		fd_stdall = open(s_stdall,
-				 O_WRONLY | O_NOCTTY | O_CREAT | O_APPEND,
-				 0644);
+		D_("StdALL: %s\n", s_stdall);
+		initng_spawn_add_open(data->plan, s_stdall,
+				      O_WRONLY | O_NOCTTY | O_CREAT | O_APPEND,
+				      1);
+		initng_spawn_add_fd(data->plan, 1, 2);
 	} else {
 		/* else set them to different files */
-		if (s_stdout)
-			fd_stdout = open(s_stdout,
-					 O_WRONLY | O_NOCTTY | O_CREAT |
-					 O_APPEND, 0644);
-		if (s_stderr)
-			fd_stderr = open(s_stderr,
-					 O_WRONLY | O_NOCTTY | O_CREAT |
-					 O_APPEND, 0644);
-	}
-
-	if (s_stdin)
-		fd_stdin = open(s_stdin, O_RDONLY | O_NOCTTY, 0644);
-
-	/* print fail messages, if the files did not open */
-	if (s_stdall && fd_stdall < 2)
-		F_("StdALL: %s, fd %i\n", s_stdall, fd_stdall);
-	if (s_stdout && fd_stdout < 2)
-		F_("StdOUT: %s, fd %i\n", s_stdout, fd_stdout);
-	if (s_stderr && fd_stderr < 2)
-		F_("StdERR: %s, fd %i\n", s_stderr, fd_stderr);
-	if (s_stdin && fd_stdin < 2)
-		F_("StdIN: %s, fd %i\n", s_stdin, fd_stdin);
-
-#ifdef DEBUG
-	if (s_stdall)
-		D_("StdALL: %s, fd %i\n", s_stdall, fd_stdall);
-	if (s_stdout)
-		D_("StdOUT: %s, fd %i\n", s_stdout, fd_stdout);
-	if (s_stderr)
-		D_("StdERR: %s, fd %i\n", s_stderr, fd_stderr);
-	if (s_stdin)
-		D_("StdIN:  %s, fd %i\n", s_stdin, fd_stdin);
-#endif
-
-	/* if fd succeeded to open */
-	if (fd_stdall > 2) {
-		/* dup both to stdall */
-		dup2(fd_stdall, 1);
-		dup2(fd_stdall, 2);
-
-		initng_io_set_cloexec(fd_stdall);
-	} else {
-		/* else dup them to diffrent fds */
-		if (fd_stdout > 2)
-			dup2(fd_stdout, 1);
-		if (fd_stderr > 2)
-			dup2(fd_stderr, 2);
-
-		initng_io_set_cloexec(fd_stdout);
-		initng_io_set_cloexec(fd_stderr);
+		if (s_stdout) {
+			D_("StdOUT: %s\n", s_stdout);
+			initng_spawn_add_open(data->plan, s_stdout,
+					      O_WRONLY | O_NOCTTY | O_CREAT |
+					      O_APPEND, 1);
+		}
+		if (s_stderr) {
+			D_("StdERR: %s\n", s_stderr);
+			initng_spawn_add_open(data->plan, s_stderr,
+					      O_WRONLY | O_NOCTTY | O_CREAT |
+					      O_APPEND, 2);
+		}
 	}
 
-	if (fd_stdin > 2) {
-		dup2(fd_stdin, 0);
-		initng_io_set_cloexec(fd_stdin);
+	if (s_stdin) {
+		D_("StdIN:  %s\n", s_stdin);
+		initng_spawn_add_open(data->plan, s_stdin, O_RDONLY | O_NOCTTY,
+				      0);
 	}
 }
 
@@ -188,7 +150,7 @@ int module_init(void)
 	initng_service_data_type_register(&STDALL);
 	initng_service_data_type_register(&STDIN);
 
-	initng_event_hook_register(&EVENT_AFTER_FORK, &setup_output);
+	initng_event_hook_register(&EVENT_SPAWN_PLAN, &setup_output);
 	return TRUE;
 }
 
@@ -199,5 +161,5 @@ void module_unload(void)
 	initng_service_data_type_unregister(&STDALL);
 	initng_service_data_type_unregister(&STDIN);
 
-	initng_event_hook_unregister(&EVENT_AFTER_FORK, &setup_output);
+	initng_event_hook_unregister(&EVENT_SPAWN_PLAN, &setup_output);
 }
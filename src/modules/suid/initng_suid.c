@@ -17,7 +17,7 @@
  *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
-#define _BSD_SOURCE	/* initgroups() */
+#define _BSD_SOURCE	/* getgrouplist() */
 
 #include <initng.h>
 
@@ -54,22 +54,9 @@ s_entry SGID = {
 	.ot = NULL,
 };
 
-void adjust_env(active_db_h * service, const char *vn, const char *vv);
-void adjust_env(active_db_h * service, const char *vn, const char *vv)
-{
-	/* add to service cache */
-	if (is_var(&ENV, vn, service)) {
-		return;		/* Assume they were set by .i file,
-				 * don't override */
-	} else {
-		set_string_var(&ENV, initng_toolbox_strdup(vn), service,
-			       initng_toolbox_strdup(vv));
-	}
-}
-
 static void do_suid(s_event * event)
 {
-	s_event_after_fork_data *data;
+	s_event_spawn_plan_data *data;
 
 	struct passwd *passwd = NULL;
 	struct group *group = NULL;
@@ -82,7 +69,7 @@ static void do_suid(s_event * event)
 	const char *groupname = NULL;
 	const char *username = NULL;
 
-	assert(event->event_type == &EVENT_AFTER_FORK);
+	assert(event->event_type == &EVENT_SPAWN_PLAN);
 	assert(event->data);
 
 	data = event->data;
@@ -105,6 +92,9 @@ static void do_suid(s_event * event)
 	} else if (username) {
 		F_("USER \"%s\" not found!\n", username);
 		ret += 2;
+
+		/* it may be added later, look again next launch */
+		data->plan->nocache = TRUE;
 	}
 
 	if (group) {
@@ -112,24 +102,34 @@ static void do_suid(s_event * event)
 	} else if (groupname) {
 		F_("GROUP \"%s\" not found!\n", groupname);
 		ret++;
+		data->plan->nocache = TRUE;
 	}
 
+	/* the child changes to them */
 	if (gid) {
 		D_("Change to gid %i", gid);
-		setgid(gid);
+		data->plan->gid = gid;
 	}
 
-	if (passwd)
-		initgroups(passwd->pw_name, passwd->pw_gid);
+	if (passwd) {
+		data->plan->groups_len = SPAWN_GROUPS;
+		if (getgrouplist(passwd->pw_name, passwd->pw_gid,
+				 data->plan->groups,
+				 &data->plan->groups_len) < 0) {
+			W_("User \"%s\" is in more than %i groups.\n",
+			   passwd->pw_name, SPAWN_GROUPS);
+			data->plan->groups_len = SPAWN_GROUPS;
+		}
+	}
 
 	if (uid) {
 		D_("Change to uid %i", uid);
-		setuid(uid);
+		data->plan->uid = uid;
 
-		/* Set UID-related env variables */
-		adjust_env(data->service, "USER", passwd->pw_name);
-		adjust_env(data->service, "HOME", passwd->pw_dir);
-		adjust_env(data->service, "PATH", "/bin:/usr/bin");
+		/* Set UID-related env variables, the plan copies them */
+		initng_spawn_add_env(data->plan, "USER", passwd->pw_name);
+		initng_spawn_add_env(data->plan, "HOME", passwd->pw_dir);
+		initng_spawn_add_env(data->plan, "PATH", "/bin:/usr/bin");
 	}
 
 	/* group and passwd are static data structures - don't free */
@@ -139,12 +139,12 @@ int module_init(void)
 {
 	initng_service_data_type_register(&SUID);
 	initng_service_data_type_register(&SGID);
-	return (initng_event_hook_register(&EVENT_AFTER_FORK, &do_suid));
+	return (initng_event_hook_register(&EVENT_SPAWN_PLAN, &do_suid));
 }
 
 void module_unload(void)
 {
 	initng_service_data_type_unregister(&SUID);
 	initng_service_data_type_unregister(&SGID);
-	initng_event_hook_unregister(&EVENT_AFTER_FORK, &do_suid);
+	initng_event_hook_unregister(&EVENT_SPAWN_PLAN, &do_suid);
 }